@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+
+// Contador global de alocações no heap. alloc_counter.cpp substitui o
+// operator new do programa para incrementar este contador; serve para
+// verificar que caminhos quentes (como atirar) não alocam em regime.
+// Só entra no jogo-check (make check, com ZOMBOID_ALLOC_COUNTER definido);
+// o jogo distribuído mantém o operator new padrão.
+std::size_t allocationCount();
@@ -0,0 +1,71 @@
+#include "assets.hpp"
+
+#include <algorithm>
+
+// Gerados por `xxd -i` em assets_data.cpp (ver makefile)
+extern unsigned char zombie_otf[];
+extern unsigned int zombie_otf_len;
+extern unsigned char zombie_png[];
+extern unsigned int zombie_png_len;
+
+EmbeddedAsset embeddedFont() {
+    return EmbeddedAsset{ zombie_otf, zombie_otf_len };
+}
+
+EmbeddedAsset embeddedZombieImage() {
+    return EmbeddedAsset{ zombie_png, zombie_png_len };
+}
+
+bool SpriteAtlas::build() {
+    sf::Image images[SPRITE_COUNT];
+    EmbeddedAsset zombie = embeddedZombieImage();
+    if (!images[SpriteZombie].loadFromMemory(zombie.data, zombie.size)) return false;
+    images[SpriteWhite].create(2, 2, sf::Color::White); // 2x2 para o centro não pegar a borda no filtro
+
+    // Largura em potência de 2 que caberia tudo numa linha, limitada pela GPU;
+    // prateleiras do mais alto para o mais baixo, quebrando linha quando enche
+    const unsigned int padding = 1;
+    unsigned int rowWidth = 0;
+    for (const sf::Image& img : images) rowWidth += img.getSize().x + padding;
+    unsigned int atlasWidth = 64;
+    while (atlasWidth < rowWidth && atlasWidth < sf::Texture::getMaximumSize()) atlasWidth *= 2;
+
+    int order[SPRITE_COUNT];
+    for (int s = 0; s < SPRITE_COUNT; ++s) order[s] = s;
+    std::sort(order, order + SPRITE_COUNT, [&](int a, int b) { return images[a].getSize().y > images[b].getSize().y; });
+
+    unsigned int x = 0, y = 0, shelfHeight = 0;
+    for (int s : order) {
+        sf::Vector2u size = images[s].getSize();
+        if (x + size.x > atlasWidth) {
+            x = 0;
+            y += shelfHeight + padding;
+            shelfHeight = 0;
+        }
+        regions[s] = sf::IntRect(static_cast<int>(x), static_cast<int>(y), static_cast<int>(size.x), static_cast<int>(size.y));
+        x += size.x + padding;
+        shelfHeight = std::max(shelfHeight, size.y);
+    }
+    unsigned int atlasHeight = y + shelfHeight;
+    if (atlasWidth > sf::Texture::getMaximumSize() || atlasHeight > sf::Texture::getMaximumSize()) return false;
+
+    sf::Image page;
+    page.create(atlasWidth, atlasHeight, sf::Color::Transparent);
+    for (int s = 0; s < SPRITE_COUNT; ++s) {
+        page.copy(images[s], static_cast<unsigned int>(regions[s].left), static_cast<unsigned int>(regions[s].top));
+    }
+    return texture.loadFromImage(page);
+}
+
+int warmGlyphs(const sf::Font& font, const unsigned int* sizes, size_t count) {
+    int glyphs = 0;
+    for (size_t k = 0; k < count; ++k) {
+        for (sf::Uint32 c = 32; c < 127; ++c) {
+            font.getGlyph(c, sizes[k], false);
+            glyphs++;
+        }
+        // sf::Text também consulta kerning e espaçamento de linha por tamanho
+        font.getLineSpacing(sizes[k]);
+    }
+    return glyphs;
+}
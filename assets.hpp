@@ -0,0 +1,50 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+
+// Assets embutidos no executável. O makefile gera assets_data.cpp com
+// `xxd -i` (um array por arquivo), então o jogo não depende do diretório de
+// trabalho nem lê disco na inicialização: fonte e imagens são carregados com
+// loadFromMemory(). Os bytes ficam vivos o programa inteiro, como a sf::Font
+// exige.
+
+struct EmbeddedAsset {
+    const unsigned char* data;
+    size_t size;
+};
+
+EmbeddedAsset embeddedFont();        // zombie.otf
+EmbeddedAsset embeddedZombieImage(); // zombie.png
+
+// Sprites do atlas
+enum AtlasSprite {
+    SpriteZombie,
+    SpriteWhite, // Texel branco: geometria sem textura (balas) amostra daqui
+    SPRITE_COUNT
+};
+
+// Todos os sprites numa textura só, empacotados em prateleiras (do mais alto
+// para o mais baixo) com 1 px de borda entre eles
+struct SpriteAtlas {
+    sf::Texture texture;
+    sf::IntRect regions[SPRITE_COUNT];
+
+    // Decodifica as imagens embutidas e monta a textura
+    bool build();
+
+    const sf::IntRect& region(AtlasSprite s) const { return regions[s]; }
+
+    // Centro do texel branco, para vértices de cor sólida
+    sf::Vector2f whiteTexel() const {
+        const sf::IntRect& r = regions[SpriteWhite];
+        return sf::Vector2f(r.left + r.width / 2.f, r.top + r.height / 2.f);
+    }
+};
+
+// Tamanhos de texto usados pelo jogo (menus, HUD e overlay do profiler)
+const unsigned int GAME_TEXT_SIZES[] = { 14, 16, 20, 25, 30, 35, 50, 60, 70 };
+
+// Rasteriza os caracteres imprimíveis em cada tamanho agora, para que nenhum
+// frame pare para criar glifos. Devolve quantos glifos foram pedidos.
+int warmGlyphs(const sf::Font& font, const unsigned int* sizes, size_t count);
@@ -0,0 +1,384 @@
+// Microbenchmarks dos caminhos quentes da simulação.
+// Uso: ./bench [--filter texto] [--out resultados.csv] [--baseline base.csv] [--tolerance 0.10]
+//
+// Cada caso roda várias repetições a partir de um estado montado fora da
+// medição e reporta a mediana. A saída é CSV (caso,parametro,entidades,
+// ns_mediana,ns_media,ns_por_entidade,repeticoes). Com --baseline, compara a
+// mediana de cada caso com a do arquivo e sai com código 1 se algum ficou
+// mais lento que a tolerância.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "simulation.hpp"
+#include "snapshot.hpp"
+#include "particles.hpp"
+
+struct BenchResult {
+    std::string name;
+    std::string param;
+    long long entities = 0;
+    double medianNs = 0.0;
+    double meanNs = 0.0;
+    int reps = 0;
+};
+
+// Passo de simulação usado nas medições (o mesmo tick do jogo)
+const float BENCH_DT = 1.f / DEFAULT_TICK_RATE;
+
+static volatile long long g_sink = 0; // Impede o compilador de descartar resultados
+
+// Mede 'reps' execuções de run(); prepare() roda antes de cada uma, fora da medição
+template <typename Prepare, typename Run>
+static BenchResult measure(const char* name, const std::string& param, long long entities, int reps,
+                           Prepare prepare, Run run) {
+    std::vector<double> times;
+    times.reserve(reps);
+    for (int r = 0; r < reps; ++r) {
+        prepare();
+        auto t0 = std::chrono::steady_clock::now();
+        run();
+        auto t1 = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+    }
+
+    BenchResult res;
+    res.name = name;
+    res.param = param;
+    res.entities = entities;
+    res.reps = reps;
+    double sum = 0.0;
+    for (double t : times) sum += t;
+    res.meanNs = sum / reps;
+    std::nth_element(times.begin(), times.begin() + reps / 2, times.end());
+    res.medianNs = times[reps / 2];
+    return res;
+}
+
+// Número pseudoaleatório determinístico em [lo, hi)
+static float randRange(float lo, float hi) {
+    return lo + (hi - lo) * (static_cast<float>(rand()) / (static_cast<float>(RAND_MAX) + 1.f));
+}
+
+// Simulação com a horda espalhada pelo mundo, longe da base, sem spawns e
+// com os players fora do jogo
+static void buildHorde(Simulation& sim, int zombies, int barricades) {
+    initSimulation(sim);
+    sim.currentWave = 1;
+    sim.zombiesToSpawn = 0;
+    sim.zombiesRemaining = zombies + 1;
+    sim.player1.alive = false;
+    sim.player2.alive = false;
+
+    sf::Vector2f basePos = sim.base.getPosition();
+    while (static_cast<int>(sim.zombies.size()) < zombies) {
+        float zx = randRange(0.f, (float)WORLD_W);
+        float zy = randRange(0.f, (float)WORLD_H);
+        if (std::hypot(zx - basePos.x, zy - basePos.y) < 200.f) continue;
+        sim.zombies.push(zx, zy, ZOMBIE_RADIUS);
+    }
+    for (int k = 0; k < barricades; ++k) {
+        sim.barricades.add(makeBarricade(sf::Vector2f(randRange(100.f, WORLD_W - 100.f), randRange(100.f, WORLD_H - 100.f))));
+    }
+    sim.barricadeVersion++;
+}
+
+// Enche o pool de balas com tiros espalhados pelo mundo em direções aleatórias
+static void fillBullets(Simulation& sim) {
+    for (int k = 0; k < sim.bullets.capacity(); ++k) {
+        float a = randRange(0.f, 6.2831853f);
+        sf::Vector2f pos(randRange(0.f, (float)WORLD_W), randRange(0.f, (float)WORLD_H));
+        sim.bullets.spawn(pos, sf::Vector2f(std::cos(a), std::sin(a)) * BULLET_SPEED, k % 2 ? OwnerPlayer2 : OwnerPlayer1);
+    }
+}
+
+static void benchCollisionFunctions(std::vector<BenchResult>& out) {
+    const int N = 1 << 16;
+    std::vector<sf::Vector2f> a(N), b(N);
+    std::vector<float> r(N);
+    for (int i = 0; i < N; ++i) {
+        a[i] = sf::Vector2f(randRange(0.f, 200.f), randRange(0.f, 200.f));
+        b[i] = sf::Vector2f(randRange(0.f, 200.f), randRange(0.f, 200.f));
+        r[i] = randRange(4.f, 40.f);
+    }
+
+    out.push_back(measure("check_circle_collision", "65536", N, 200, [] {}, [&] {
+        long long hits = 0;
+        for (int i = 0; i < N; ++i) hits += checkCircleCollision(a[i], r[i], b[i], ZOMBIE_RADIUS);
+        g_sink = g_sink + hits;
+    }));
+    out.push_back(measure("check_circle_rect_collision", "65536", N, 200, [] {}, [&] {
+        long long hits = 0;
+        for (int i = 0; i < N; ++i) hits += checkCircleRectCollision(a[i], r[i], b[i], BARRICADE_SIZE);
+        g_sink = g_sink + hits;
+    }));
+}
+
+// Movimento da horda mais contato com barricadas, com 0 a 64 barricadas
+static void benchSteering(std::vector<BenchResult>& out) {
+    const int zombies = 2000;
+    static const int barricadeCounts[] = { 0, 1, 4, 16, 64 };
+    for (int barricades : barricadeCounts) {
+        srand(1000 + barricades);
+        Simulation proto;
+        buildHorde(proto, zombies, barricades);
+        updateZombies(proto, BENCH_DT); // Monta o campo de fluxo e as listas por célula fora da medição
+
+        Simulation sim;
+        out.push_back(measure("steering", std::to_string(barricades) + "_barricadas", zombies, 300,
+            [&] { sim = proto; },
+            [&] {
+                updateZombies(sim, BENCH_DT);
+                resolveZombieContacts(sim, BENCH_DT);
+            }));
+    }
+}
+
+// Balas (pool cheio) contra hordas crescentes
+static void benchBulletZombie(std::vector<BenchResult>& out) {
+    static const int zombieCounts[] = { 100, 1000, 10000, 100000 };
+    for (int zombies : zombieCounts) {
+        srand(2000 + zombies);
+        Simulation proto;
+        buildHorde(proto, zombies, 0);
+        fillBullets(proto);
+
+        Simulation sim;
+        int reps = zombies >= 100000 ? 40 : 200;
+        out.push_back(measure("bullet_zombie", std::to_string(zombies) + "_zumbis", zombies, reps,
+            [&] { sim = proto; },
+            [&] { updateBullets(sim, BENCH_DT); }));
+    }
+}
+
+// Dano da explosão sobre hordas crescentes (raio de EXPLOSION_RADIUS no meio da horda)
+static void benchExplosion(std::vector<BenchResult>& out) {
+    static const int zombieCounts[] = { 1000, 10000, 100000 };
+    for (int zombies : zombieCounts) {
+        srand(3000 + zombies);
+        Simulation proto;
+        buildHorde(proto, zombies, 0);
+
+        Simulation sim;
+        int reps = zombies >= 100000 ? 40 : 200;
+        sf::Vector2f center(WORLD_W / 4.f, WORLD_H / 4.f);
+        out.push_back(measure("explosion_sweep", std::to_string(zombies) + "_zumbis", zombies, reps,
+            [&] { sim = proto; },
+            [&] { g_sink = g_sink + damageZombiesInRadius(sim, center, EXPLOSION_RADIUS); }));
+    }
+}
+
+// Explosão com cadeia de EXPLOSION_CHAIN_RADIUS até esgotar as gerações; o
+// custo deve seguir os zumbis atingidos, não o tamanho da horda
+static void benchAreaChain(std::vector<BenchResult>& out) {
+    static const int zombieCounts[] = { 10000, 100000 };
+    static const int depths[] = { 1, 3 };
+    for (int zombies : zombieCounts) {
+        for (int depth : depths) {
+            srand(3500 + zombies + depth);
+            Simulation proto;
+            buildHorde(proto, zombies, 0);
+
+            Simulation sim;
+            int reps = zombies >= 100000 ? 20 : 100;
+            out.push_back(measure("area_chain", std::to_string(zombies) + "_zumbis_cadeia_" + std::to_string(depth),
+                zombies, reps,
+                [&] { sim = proto; },
+                [&] {
+                    updateBullets(sim, 0.f); // Sem balas: só monta a grade
+                    AreaEffect blast;
+                    blast.position = sf::Vector2f(WORLD_W / 4.f, WORLD_H / 4.f);
+                    blast.radius = EXPLOSION_RADIUS;
+                    blast.chainDepth = depth;
+                    spawnAreaEffect(sim, blast);
+                    for (int g = 0; g <= depth; ++g) g_sink = g_sink + updateAreaEffects(sim, EXPLOSION_CHAIN_FUSE);
+                    sim.zombies.removeDead();
+                }));
+        }
+    }
+}
+
+// Tick completo com a horda do tamanho de uma wave, players vivos atirando e barricadas
+static void benchFullTick(std::vector<BenchResult>& out) {
+    static const int waves[] = { 1, 50, 200, 1000 };
+    for (int wave : waves) {
+        int zombies = INITIAL_ZOMBIES + (wave - 1) * ZOMBIE_INCREMENT_PER_WAVE;
+        srand(4000 + wave);
+        Simulation proto;
+        buildHorde(proto, zombies, 8);
+        proto.currentWave = wave;
+        proto.player1.alive = true;
+        proto.player2.alive = true;
+        fillBullets(proto);
+        stepSimulation(proto, TickInput(), BENCH_DT); // Monta grade e campo de fluxo
+
+        TickInput input;
+        input.p1.shoot = true;
+        input.p1.up = true;
+        input.p2.shoot = true;
+        input.p2.down = true;
+
+        Simulation sim;
+        out.push_back(measure("full_tick", "wave_" + std::to_string(wave), zombies, 200,
+            [&] { sim = proto; },
+            [&] { stepSimulation(sim, input, BENCH_DT); }));
+    }
+}
+
+// Salvar e restaurar um snapshot com hordas crescentes, balas e barricadas
+static void benchSnapshot(std::vector<BenchResult>& out) {
+    static const int zombieCounts[] = { 1000, 10000, 100000 };
+    for (int zombies : zombieCounts) {
+        srand(5000 + zombies);
+        Simulation sim;
+        buildHorde(sim, zombies, 8);
+        fillBullets(sim);
+
+        std::vector<unsigned char> bytes;
+        saveSnapshot(sim, bytes); // Aquece o buffer
+        int reps = zombies >= 100000 ? 40 : 200;
+        out.push_back(measure("snapshot_save", std::to_string(zombies) + "_zumbis", zombies, reps,
+            [] {},
+            [&] { saveSnapshot(sim, bytes); g_sink = g_sink + static_cast<long long>(bytes.size()); }));
+        out.push_back(measure("snapshot_load", std::to_string(zombies) + "_zumbis", zombies, reps,
+            [] {},
+            [&] { g_sink = g_sink + loadSnapshot(sim, bytes.data(), bytes.size()); }));
+    }
+}
+
+static std::string resultKey(const std::string& name, const std::string& param) {
+    return name + "/" + param;
+}
+
+// Lê a mediana de cada caso de um CSV gerado por este programa
+static bool readBaseline(const char* path, std::map<std::string, double>& baseline) {
+    std::FILE* f = std::fopen(path, "r");
+    if (!f) return false;
+    char line[512];
+    while (std::fgets(line, sizeof(line), f)) {
+        char name[128], param[128];
+        long long entities;
+        double median;
+        if (std::sscanf(line, "%127[^,],%127[^,],%lld,%lf", name, param, &entities, &median) == 4) {
+            baseline[resultKey(name, param)] = median;
+        }
+    }
+    std::fclose(f);
+    return true;
+}
+
+static void writeResults(std::FILE* f, const std::vector<BenchResult>& results) {
+    std::fprintf(f, "caso,parametro,entidades,ns_mediana,ns_media,ns_por_entidade,repeticoes\n");
+    for (const BenchResult& r : results) {
+        std::fprintf(f, "%s,%s,%lld,%.1f,%.1f,%.3f,%d\n", r.name.c_str(), r.param.c_str(), r.entities,
+                     r.medianNs, r.meanNs, r.entities > 0 ? r.medianNs / r.entities : 0.0, r.reps);
+    }
+}
+
+// Partículas: um frame (update + montagem dos quads) com o pool cheio de sangue e ondas de choque
+static void benchParticles(std::vector<BenchResult>& out) {
+    static const int particleCounts[] = { 10000, 30000, 60000 };
+    const sf::FloatRect view(0.f, 0.f, static_cast<float>(WORLD_W), static_cast<float>(WORLD_H));
+    for (int target : particleCounts) {
+        srand(6000 + target);
+        std::vector<SimEvent> events;
+        for (int k = 0; k < 400; ++k) {
+            SimEvent e{ k % 10 == 0 ? EventExplosion : EventZombieKilled, OwnerPlayer1,
+                        randRange(0.f, (float)WORLD_W), randRange(0.f, (float)WORLD_H), 1.f, 0.f, EXPLOSION_RADIUS };
+            events.push_back(e);
+        }
+
+        ParticleSystem proto;
+        proto.init(PARTICLE_CAPACITY, 1);
+        while (proto.count < static_cast<size_t>(target)) proto.emitEvents(events);
+        proto.count = static_cast<size_t>(target);
+
+        ParticleSystem particles;
+        out.push_back(measure("particles_frame", std::to_string(target) + "_particulas", target, 200,
+            [&] { particles = proto; },
+            [&] {
+                particles.update(BENCH_DT);
+                particles.build(view, sf::Vector2f(0.f, 0.f));
+                g_sink = g_sink + static_cast<long long>(particles.vertices.getVertexCount());
+            }));
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const char* filter = nullptr;
+    const char* outPath = nullptr;
+    const char* baselinePath = nullptr;
+    double tolerance = 0.10;
+    for (int a = 1; a < argc; ++a) {
+        if (std::strcmp(argv[a], "--filter") == 0 && a + 1 < argc) filter = argv[++a];
+        else if (std::strcmp(argv[a], "--out") == 0 && a + 1 < argc) outPath = argv[++a];
+        else if (std::strcmp(argv[a], "--baseline") == 0 && a + 1 < argc) baselinePath = argv[++a];
+        else if (std::strcmp(argv[a], "--tolerance") == 0 && a + 1 < argc) tolerance = std::atof(argv[++a]);
+        else {
+            std::fprintf(stderr, "uso: %s [--filter texto] [--out arquivo.csv] [--baseline arquivo.csv] [--tolerance 0.10]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    typedef void (*BenchFn)(std::vector<BenchResult>&);
+    static const std::pair<const char*, BenchFn> suites[] = {
+        { "check_circle", benchCollisionFunctions },
+        { "steering", benchSteering },
+        { "bullet_zombie", benchBulletZombie },
+        { "explosion_sweep", benchExplosion },
+        { "area_chain", benchAreaChain },
+        { "full_tick", benchFullTick },
+        { "snapshot", benchSnapshot },
+        { "particles", benchParticles },
+    };
+
+    std::vector<BenchResult> results;
+    for (const auto& suite : suites) {
+        if (filter && !std::strstr(suite.first, filter)) continue;
+        suite.second(results);
+    }
+
+    writeResults(stdout, results);
+    if (outPath) {
+        std::FILE* f = std::fopen(outPath, "w");
+        if (!f) {
+            std::fprintf(stderr, "bench: nao foi possivel gravar %s\n", outPath);
+            return 2;
+        }
+        writeResults(f, results);
+        std::fclose(f);
+    }
+
+    if (!baselinePath) return 0;
+
+    std::map<std::string, double> baseline;
+    if (!readBaseline(baselinePath, baseline)) {
+        std::fprintf(stderr, "bench: nao foi possivel ler %s\n", baselinePath);
+        return 2;
+    }
+
+    // Comparação com a referência: razão > 1 + tolerância conta como regressão
+    int regressions = 0;
+    std::printf("\ncomparacao com %s (tolerancia %.0f%%)\n", baselinePath, tolerance * 100.0);
+    for (const BenchResult& r : results) {
+        auto it = baseline.find(resultKey(r.name, r.param));
+        if (it == baseline.end() || it->second <= 0.0) {
+            std::printf("%-30s %-16s sem referencia\n", r.name.c_str(), r.param.c_str());
+            continue;
+        }
+        double ratio = r.medianNs / it->second;
+        bool regressed = ratio > 1.0 + tolerance;
+        regressions += regressed;
+        std::printf("%-30s %-16s %+7.1f%% %s\n", r.name.c_str(), r.param.c_str(), (ratio - 1.0) * 100.0,
+                    regressed ? "REGRESSAO" : (ratio < 1.0 - tolerance ? "melhor" : "ok"));
+    }
+    return regressions > 0 ? 1 : 0;
+}
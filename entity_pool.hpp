@@ -0,0 +1,39 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+// Pool denso de entidades: os itens ficam contíguos em 'items' (dá para
+// iterar como um vetor) e a remoção é O(1) trocando o item removido pelo
+// último (swap-and-pop), então a ordem dos itens não é mantida. Ninguém
+// guarda referências para os itens entre ticks: quem precisa achar uma
+// entidade usa índices refeitos quando o pool muda (como as listas de
+// barricadas por célula, que seguem barricadeVersion).
+// Remover durante uma iteração por índice é seguro se a iteração for de trás
+// para frente.
+template <typename T>
+struct EntityPool {
+    std::vector<T> items; // itens vivos, contíguos
+
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+
+    T& operator[](size_t i) { return items[i]; }
+    const T& operator[](size_t i) const { return items[i]; }
+
+    typename std::vector<T>::iterator begin() { return items.begin(); }
+    typename std::vector<T>::iterator end() { return items.end(); }
+    typename std::vector<T>::const_iterator begin() const { return items.begin(); }
+    typename std::vector<T>::const_iterator end() const { return items.end(); }
+
+    void add(const T& value) { items.push_back(value); }
+
+    // Remove o item da posição 'i' em O(1): o último item ocupa o lugar dele
+    void removeAt(size_t i) {
+        size_t last = items.size() - 1;
+        if (i != last) items[i] = std::move(items[last]);
+        items.pop_back();
+    }
+
+    void clear() { items.clear(); }
+};
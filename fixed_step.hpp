@@ -0,0 +1,40 @@
+#pragma once
+
+// Passo fixo da simulação: acumula o tempo real de cada frame e diz quantos
+// ticks de 'tickDt' rodar, independente do frame rate. Se o frame demorar
+// demais (janela arrastada, travada do sistema), roda no máximo
+// 'maxStepsPerFrame' ticks e descarta o resto, em vez de tentar recuperar e
+// travar ainda mais. 'alpha' é quanto do próximo tick já passou, para a
+// renderização interpolar entre o estado anterior e o atual.
+struct FixedStep {
+    float tickDt = 1.f / 60.f;
+    int maxStepsPerFrame = 5;
+    double accumulator = 0.0;
+    long long droppedTicks = 0; // Ticks descartados pelo limite de recuperação
+
+    void init(int tickRate, int maxSteps) {
+        tickDt = 1.f / static_cast<float>(tickRate > 0 ? tickRate : 1);
+        maxStepsPerFrame = maxSteps > 0 ? maxSteps : 1;
+        reset();
+    }
+
+    // Zera o tempo acumulado (ao começar uma partida ou sair do pause)
+    void reset() { accumulator = 0.0; }
+
+    // Soma o tempo do frame e devolve quantos ticks rodar agora
+    int advance(float frameSeconds) {
+        accumulator += frameSeconds;
+        int steps = static_cast<int>(accumulator / tickDt);
+        if (steps > maxStepsPerFrame) {
+            droppedTicks += steps - maxStepsPerFrame;
+            steps = maxStepsPerFrame;
+            accumulator = static_cast<double>(steps) * tickDt; // Sobra nada além dos ticks que vão rodar
+        }
+        accumulator -= static_cast<double>(steps) * tickDt;
+        if (accumulator < 0.0) accumulator = 0.0;
+        return steps;
+    }
+
+    // Fração do próximo tick já acumulada, em [0, 1)
+    float alpha() const { return static_cast<float>(accumulator / tickDt); }
+};
@@ -0,0 +1,122 @@
+#include "flow_field.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+void FlowField::init(float minX, float minY, float maxX, float maxY, float cell) {
+    originX = minX;
+    originY = minY;
+    cellSize = cell;
+    cols = std::max(1, static_cast<int>((maxX - minX) / cell) + 1);
+    rows = std::max(1, static_cast<int>((maxY - minY) / cell) + 1);
+
+    const size_t cells = static_cast<size_t>(cols) * rows;
+    cost.assign(cells, 1.f);
+    distance.assign(cells, std::numeric_limits<float>::max());
+    direction.assign(cells, sf::Vector2f(0.f, 0.f));
+    goal.assign(cells, 0);
+    built = false;
+}
+
+int FlowField::cellX(float x) const {
+    float fx = (x - originX) / cellSize;
+    if (!(fx > 0.f)) return 0;
+    if (fx >= static_cast<float>(cols)) return cols - 1;
+    return static_cast<int>(fx);
+}
+
+int FlowField::cellY(float y) const {
+    float fy = (y - originY) / cellSize;
+    if (!(fy > 0.f)) return 0;
+    if (fy >= static_cast<float>(rows)) return rows - 1;
+    return static_cast<int>(fy);
+}
+
+int FlowField::cellIndex(float x, float y) const {
+    return cellY(y) * cols + cellX(x);
+}
+
+void FlowField::build(sf::Vector2f target, const std::vector<sf::FloatRect>& obstacles,
+                      float agentRadius, float obstacleCost) {
+    std::fill(cost.begin(), cost.end(), 1.f);
+    std::fill(distance.begin(), distance.end(), std::numeric_limits<float>::max());
+    std::fill(goal.begin(), goal.end(), 0);
+
+    // Marca as células cobertas pelos obstáculos, expandidos pelo raio do agente
+    for (const sf::FloatRect& r : obstacles) {
+        int x0 = cellX(r.left - agentRadius);
+        int x1 = cellX(r.left + r.width + agentRadius);
+        int y0 = cellY(r.top - agentRadius);
+        int y1 = cellY(r.top + r.height + agentRadius);
+        for (int cy = y0; cy <= y1; ++cy) {
+            for (int cx = x0; cx <= x1; ++cx) {
+                cost[cy * cols + cx] = obstacleCost;
+            }
+        }
+    }
+
+    // Dijkstra a partir da célula da base
+    typedef std::pair<float, int> Node;
+    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> open;
+    int start = cellIndex(target.x, target.y);
+    distance[start] = 0.f;
+    goal[start] = 1;
+    open.push(Node(0.f, start));
+
+    static const int dx[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+    static const int dy[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+    static const float stepLen[8] = { 1.f, 1.f, 1.f, 1.f, 1.41421356f, 1.41421356f, 1.41421356f, 1.41421356f };
+
+    while (!open.empty()) {
+        Node n = open.top();
+        open.pop();
+        int c = n.second;
+        if (n.first > distance[c]) continue;
+
+        int cx = c % cols;
+        int cy = c / cols;
+        for (int k = 0; k < 8; ++k) {
+            int nx = cx + dx[k];
+            int ny = cy + dy[k];
+            if (nx < 0 || ny < 0 || nx >= cols || ny >= rows) continue;
+            int nc = ny * cols + nx;
+            // Custo médio das duas células: sair de uma barricada também é caro
+            float d = distance[c] + stepLen[k] * 0.5f * (cost[c] + cost[nc]);
+            if (d < distance[nc]) {
+                distance[nc] = d;
+                open.push(Node(d, nc));
+            }
+        }
+    }
+
+    // Direção de cada célula: para o vizinho com a menor distância
+    for (int cy = 0; cy < rows; ++cy) {
+        for (int cx = 0; cx < cols; ++cx) {
+            int c = cy * cols + cx;
+            int best = -1;
+            float bestDist = distance[c];
+            for (int k = 0; k < 8; ++k) {
+                int nx = cx + dx[k];
+                int ny = cy + dy[k];
+                if (nx < 0 || ny < 0 || nx >= cols || ny >= rows) continue;
+                float d = distance[ny * cols + nx];
+                if (d < bestDist) {
+                    bestDist = d;
+                    best = k;
+                }
+            }
+            if (best < 0) {
+                direction[c] = sf::Vector2f(0.f, 0.f);
+            } else {
+                float len = stepLen[best];
+                direction[c] = sf::Vector2f(dx[best] / len, dy[best] / len);
+            }
+        }
+    }
+
+    built = true;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+// Campo de fluxo para a horda: uma grade sobre o mundo onde cada célula guarda
+// a direção do caminho mais barato até a base (Dijkstra a partir da base, 8
+// vizinhos). Barricadas não bloqueiam, só deixam as células delas caras, então
+// os zumbis contornam barricadas soltas e só atravessam (atacando) quando o
+// desvio sai mais caro. O campo só é recalculado quando as barricadas mudam;
+// cada zumbi lê sua direção com uma consulta de célula.
+struct FlowField {
+    float originX = 0.f;
+    float originY = 0.f;
+    float cellSize = 20.f;
+    int cols = 0;
+    int rows = 0;
+
+    std::vector<float> cost;              // Custo para entrar em cada célula
+    std::vector<float> distance;          // Distância ponderada até a base
+    std::vector<sf::Vector2f> direction;  // Direção normalizada para o próximo passo
+    std::vector<char> goal;               // Célula da base: o zumbi vai direto ao centro
+
+    unsigned builtVersion = 0; // Versão das barricadas usada no último build
+    bool built = false;
+
+    // Define a área coberta e o tamanho das células
+    void init(float minX, float minY, float maxX, float maxY, float cell);
+
+    // Célula de uma coordenada, presa à borda da grade
+    int cellX(float x) const;
+    int cellY(float y) const;
+    int cellIndex(float x, float y) const;
+
+    // Recalcula o campo até 'target'. Células que tocam algum obstáculo
+    // (expandido por 'agentRadius') custam 'obstacleCost' vezes mais.
+    void build(sf::Vector2f target, const std::vector<sf::FloatRect>& obstacles,
+               float agentRadius, float obstacleCost);
+};
@@ -0,0 +1,667 @@
+#include "headless.hpp"
+#include "replay.hpp"
+#include "snapshot.hpp"
+#include "alloc_counter.hpp"
+#include "simd_kernels.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <limits>
+#include <vector>
+
+// Converte um vetor para a tecla de direção (8 direções) mais próxima
+static void pressTowards(PlayerInput& p, sf::Vector2f v) {
+    float len = std::hypot(v.x, v.y);
+    if (len <= 0.f) return;
+    p.left = v.x < -0.38f * len;  // 0.38 ~ sin(22.5 graus)
+    p.right = v.x > 0.38f * len;
+    p.up = v.y < -0.38f * len;
+    p.down = v.y > 0.38f * len;
+}
+
+// Bot de um player: vai até o posto ao lado da base e, de lá, mira no zumbi
+// mais próximo da base. Como a mira é a última direção andada, o bot alterna
+// um tick andando para o alvo (e atira) e um tick voltando, ficando no lugar.
+static PlayerInput guardInput(const Simulation& sim, const Player& player, sf::Vector2f post, long long tick) {
+    PlayerInput in;
+    sf::Vector2f pos = player.shape.getPosition();
+    sf::Vector2f toPost = post - pos;
+    if (std::hypot(toPost.x, toPost.y) > 20.f) {
+        pressTowards(in, toPost);
+        return in;
+    }
+
+    const ZombieStore& zs = sim.zombies;
+    int target = -1;
+    float best = std::numeric_limits<float>::max();
+    sf::Vector2f basePos = sim.base.getPosition();
+    for (size_t i = 0; i < zs.size(); ++i) {
+        float dx = zs.x[i] - basePos.x;
+        float dy = zs.y[i] - basePos.y;
+        float dist = dx * dx + dy * dy;
+        if (dist < best) {
+            best = dist;
+            target = static_cast<int>(i);
+        }
+    }
+    if (target < 0) return in;
+
+    sf::Vector2f aim = zs.position(target) - pos;
+    if (tick % 2 == 0) {
+        pressTowards(in, aim);
+        in.shoot = true;
+    } else {
+        pressTowards(in, -aim);
+    }
+    return in;
+}
+
+TickInput scriptedInput(const Simulation& sim, long long tick) {
+    TickInput in;
+    sf::Vector2f basePos = sim.base.getPosition();
+    in.p1 = guardInput(sim, sim.player1, basePos + sf::Vector2f(-40.f, 0.f), tick);
+    in.p2 = guardInput(sim, sim.player2, basePos + sf::Vector2f(40.f, 0.f), tick);
+
+    // Usa as habilidades assim que ficam prontas
+    in.p1.ability = sim.player1.abilityTimer >= PLAYER1_ABILITY_COOLDOWN;
+    in.p2.ability = sim.player2.abilityTimer >= PLAYER2_ABILITY_COOLDOWN;
+    return in;
+}
+
+int runHeadless(long long ticks, const char* recordPath) {
+    if (ticks <= 0) {
+        std::fprintf(stderr, "headless: numero de ticks invalido\n");
+        return 1;
+    }
+
+    JobSystem jobs;
+    jobs.init(0);
+
+    // Sementes fixas (uma por partida) para execuções comparáveis
+    Simulation sim;
+    initSimulation(sim);
+    sim.jobs = &jobs;
+    startGame(sim, HEADLESS_SEED);
+
+    // Com --record, grava a primeira partida
+    ReplayRecorder recorder;
+    bool recording = recordPath != nullptr;
+    if (recording) recorder.begin(HEADLESS_SEED, DEFAULT_TICK_RATE);
+
+    std::vector<double> tickMicros;
+    tickMicros.reserve(static_cast<size_t>(ticks));
+
+    int gamesPlayed = 1;
+    int maxWave = 0;
+    size_t maxZombies = 0;
+
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+
+    for (long long t = 0; t < ticks; ++t) {
+        TickInput in = scriptedInput(sim, t);
+
+        auto t0 = clock::now();
+        stepSimulation(sim, in, HEADLESS_DT);
+        auto t1 = clock::now();
+        tickMicros.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+
+        if (recording) {
+            recorder.record(in, sim);
+            if (sim.gameOver || t + 1 == ticks) {
+                if (!recorder.save(recordPath)) std::fprintf(stderr, "headless: nao foi possivel gravar %s\n", recordPath);
+                else std::printf("replay: %zu ticks gravados em %s\n", recorder.tickCount(), recordPath);
+                recording = false;
+            }
+        }
+
+        maxWave = std::max(maxWave, sim.currentWave);
+        maxZombies = std::max(maxZombies, sim.zombies.size());
+
+        // Soak: quando a base cai, reinicia e continua contando
+        if (sim.gameOver) {
+            startGame(sim, HEADLESS_SEED + gamesPlayed);
+            gamesPlayed++;
+        }
+    }
+
+    double totalSec = std::chrono::duration<double>(clock::now() - start).count();
+
+    double sum = 0.0;
+    for (double us : tickMicros) sum += us;
+    std::vector<double> sorted = tickMicros;
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&](double p) {
+        size_t idx = static_cast<size_t>(p * (sorted.size() - 1));
+        return sorted[idx];
+    };
+
+    std::printf("ticks:            %lld\n", ticks);
+    std::printf("tempo total:      %.3f s\n", totalSec);
+    std::printf("ticks/s:          %.0f\n", ticks / totalSec);
+    std::printf("latencia media:   %.2f us\n", sum / sorted.size());
+    std::printf("latencia p50:     %.2f us\n", percentile(0.50));
+    std::printf("latencia p99:     %.2f us\n", percentile(0.99));
+    std::printf("latencia max:     %.2f us\n", sorted.back());
+    std::printf("partidas:         %d\n", gamesPlayed);
+    std::printf("maior wave:       %d\n", maxWave);
+    std::printf("max zumbis vivos: %zu\n", maxZombies);
+    return 0;
+}
+
+int runAllocCheck() {
+#ifndef ZOMBOID_ALLOC_COUNTER
+    std::fprintf(stderr, "--check-alloc precisa do contador de alocacoes: use o jogo-check (make check)\n");
+    return 1;
+#else
+    Simulation sim;
+    initSimulation(sim);
+
+    // Wave vazia que nunca termina: isola o caminho de tiro dos spawns de zumbis
+    sim.currentWave = 1;
+    sim.zombiesToSpawn = 0;
+    sim.zombiesRemaining = 1;
+
+    // Os dois players atiram sem parar, girando pelas 8 direções
+    auto firingInput = [](long long tick) {
+        TickInput in;
+        int dir = static_cast<int>(tick / 30 % 8);
+        static const int dx[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+        static const int dy[8] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+        // Anda e volta para mirar sem sair do lugar
+        int sign = (tick % 2 == 0) ? 1 : -1;
+        for (PlayerInput* p : { &in.p1, &in.p2 }) {
+            p->left = dx[dir] * sign < 0;
+            p->right = dx[dir] * sign > 0;
+            p->up = dy[dir] * sign < 0;
+            p->down = dy[dir] * sign > 0;
+            p->shoot = true;
+        }
+        return in;
+    };
+
+    const long long warmupTicks = 600;
+    const long long measuredTicks = 20000;
+    for (long long t = 0; t < warmupTicks; ++t) {
+        stepSimulation(sim, firingInput(t), HEADLESS_DT);
+    }
+
+    std::size_t before = allocationCount();
+    int maxBullets = 0;
+    for (long long t = warmupTicks; t < warmupTicks + measuredTicks; ++t) {
+        stepSimulation(sim, firingInput(t), HEADLESS_DT);
+        maxBullets = std::max(maxBullets, sim.bullets.size());
+    }
+    std::size_t allocations = allocationCount() - before;
+
+    std::printf("ticks medidos:       %lld\n", measuredTicks);
+    std::printf("capacidade do pool:  %d\n", sim.bullets.capacity());
+    std::printf("max balas vivas:     %d\n", maxBullets);
+    std::printf("transbordos do pool: %d\n", sim.bullets.overflows);
+    std::printf("alocacoes:           %zu\n", allocations);
+
+    bool ok = allocations == 0 && sim.bullets.overflows == 0;
+    std::printf("%s\n", ok ? "OK: atirar nao aloca memoria" : "FALHA");
+    return ok ? 0 : 1;
+#endif
+}
+
+int runTunnelingCheck() {
+    // Uma bala em linha reta contra um zumbi parado (ou uma barricada com um
+    // zumbi atrás), com o alvo em todos os deslocamentos de 1 px ao longo de
+    // um passo inteiro e em várias alturas: acertos no caminho não podem
+    // depender de onde o alvo cai entre duas posições da bala
+    static const int tickRates[] = { 60, 20, 10, 5 };
+    static const float lateral[] = { -16.f, -8.f, 0.f, 8.f, 16.f }; // Todos a menos de BULLET_RADIUS + ZOMBIE_RADIUS
+    const float missLateral = BULLET_RADIUS + ZOMBIE_RADIUS + 1.f;
+    const sf::Vector2f origin(300.f, 600.f);
+
+    // Roda só as balas até a bala sumir; devolve se o zumbi morreu
+    auto shoot = [&](float dt, sf::Vector2f zombie, bool barricade) {
+        Simulation sim;
+        initSimulation(sim);
+        sim.zombies.push(zombie.x, zombie.y, ZOMBIE_RADIUS);
+        sim.zombiesRemaining = 1;
+        if (barricade) {
+            sim.barricades.add(makeBarricade(zombie - sf::Vector2f(100.f, 0.f)));
+            sim.barricadeVersion++;
+        }
+        sim.bullets.spawn(origin, sf::Vector2f(BULLET_SPEED, 0.f), OwnerPlayer1);
+        for (int t = 0; t < 1000 && sim.bullets.size() > 0; ++t) updateBullets(sim, dt);
+        return sim.zombies.empty();
+    };
+
+    bool ok = true;
+    for (int rate : tickRates) {
+        float dt = 1.f / rate;
+        int step = static_cast<int>(BULLET_SPEED * dt);
+        int shots = 0, hits = 0, blocked = 0, misses = 0;
+        for (int off = 0; off < step; ++off) {
+            for (float lat : lateral) {
+                sf::Vector2f zombie(origin.x + 300.f + off, origin.y + lat);
+                shots++;
+                hits += shoot(dt, zombie, false) ? 1 : 0;
+                blocked += shoot(dt, zombie, true) ? 0 : 1;
+            }
+            misses += shoot(dt, sf::Vector2f(origin.x + 300.f + off, origin.y + missLateral), false) ? 0 : 1;
+        }
+        bool rateOk = hits == shots && blocked == shots && misses == step;
+        ok = ok && rateOk;
+        std::printf("%3d ticks/s (%3d px por tick): acertos %d/%d, seguras pela barricada %d/%d, desvios %d/%d%s\n",
+                    rate, step, hits, shots, blocked, shots, misses, step, rateOk ? "" : "  <- FALHA");
+    }
+    // A cobertura vale pelo ponto de onde a bala saiu, não por onde o atirador
+    // está: o player anda (aqui, teleporta) a cada tick com a bala no ar
+    auto coverShot = [&](sf::Vector2f barricade, sf::Vector2f moveTo) {
+        Simulation sim;
+        initSimulation(sim);
+        sim.player1.shape.setPosition(origin);
+        sf::Vector2f zombie(origin.x + 300.f, origin.y);
+        sim.zombies.push(zombie.x, zombie.y, ZOMBIE_RADIUS);
+        sim.zombiesRemaining = 1;
+        sim.barricades.add(makeBarricade(barricade));
+        sim.barricadeVersion++;
+        sim.bullets.spawn(origin, sf::Vector2f(BULLET_SPEED, 0.f), OwnerPlayer1);
+        for (int t = 0; t < 1000 && sim.bullets.size() > 0; ++t) {
+            updateBullets(sim, 1.f / 60.f);
+            sim.player1.shape.setPosition(moveTo);
+        }
+        return sim.zombies.empty();
+    };
+    // Encostado na barricada, como placeBarricade a coloca
+    Simulation probe;
+    initSimulation(probe);
+    const float besideCover = BARRICADE_SIZE.x / 2.f + probe.player1.shape.getRadius() + BARRICADE_GAP;
+    const sf::Vector2f cover = origin + sf::Vector2f(besideCover, 0.f);
+    const sf::Vector2f far = origin + sf::Vector2f(200.f, 0.f);
+    const sf::Vector2f beside = far - sf::Vector2f(besideCover, 0.f);
+    bool coverOk = coverShot(cover, origin);          // Parado atrás da própria cobertura
+    bool leaveOk = coverShot(cover, origin - sf::Vector2f(0.f, 300.f)); // Sai dela com a bala no ar
+    bool joinOk = !coverShot(far, beside);            // Chega a outra com a bala no ar
+    ok = ok && coverOk && leaveOk && joinOk;
+    std::printf("barricada do atirador: %s; saindo da cobertura: %s; chegando em outra: %s\n",
+                coverOk ? "atira por cima" : "FALHA", leaveOk ? "atira por cima" : "FALHA",
+                joinOk ? "segura" : "FALHA");
+    std::printf("%s\n", ok ? "OK: nenhuma bala atravessa zumbis ou barricadas" : "FALHA");
+    return ok ? 0 : 1;
+}
+
+int runAreaCheck() {
+    // Detona um efeito sobre zumbis parados e devolve quais morreram (na
+    // ordem em que foram postos), rodando só balas e efeitos até a cadeia
+    // inteira ter detonado
+    auto detonate = [](const AreaEffect& effect, const std::vector<sf::Vector2f>& zombies) {
+        Simulation sim;
+        initSimulation(sim);
+        std::vector<std::uint32_t> ids;
+        for (sf::Vector2f z : zombies) {
+            sim.zombies.push(z.x, z.y, ZOMBIE_RADIUS);
+            ids.push_back(sim.zombies.id.back());
+        }
+        sim.zombiesRemaining = static_cast<int>(zombies.size());
+        spawnAreaEffect(sim, effect);
+        for (int g = 0; g <= effect.chainDepth + 1; ++g) {
+            updateBullets(sim, 0.f); // Sem balas: só monta a grade
+            updateAreaEffects(sim, EXPLOSION_CHAIN_FUSE);
+            sim.zombies.removeDead();
+        }
+        std::vector<bool> killed(zombies.size(), true);
+        for (std::uint32_t id : sim.zombies.id) {
+            for (size_t k = 0; k < ids.size(); ++k) {
+                if (ids[k] == id) killed[k] = false;
+            }
+        }
+        return killed;
+    };
+
+    bool ok = true;
+
+    // Cone de 60 graus para a direita: mata os dois dentro da abertura (um
+    // de cada lado do eixo), poupa os de fora do ângulo, atrás e longe demais
+    {
+        AreaEffect cone;
+        cone.shape = AreaCone;
+        cone.position = sf::Vector2f(400.f, 400.f);
+        cone.direction = sf::Vector2f(1.f, 0.f);
+        cone.coneCos = std::cos(30.f * 3.14159265f / 180.f);
+        cone.radius = 150.f;
+        cone.owner = OwnerPlayer1;
+        std::vector<sf::Vector2f> zombies = {
+            { 500.f, 400.f }, // No eixo
+            { 500.f, 440.f }, // 22 graus acima do eixo
+            { 500.f, 360.f }, // 22 graus abaixo
+            { 500.f, 500.f }, // 45 graus: fora da abertura
+            { 300.f, 400.f }, // Atrás
+            { 600.f, 400.f }, // No eixo, além do raio
+        };
+        std::vector<bool> expected = { true, true, true, false, false, false };
+        bool coneOk = detonate(cone, zombies) == expected;
+        ok = ok && coneOk;
+        std::printf("cone: %s\n", coneOk ? "mata so os de dentro da abertura" : "FALHA");
+    }
+
+    // Fila de zumbis a 50 px um do outro: cada detonação em cadeia alcança só
+    // o vizinho (EXPLOSION_CHAIN_RADIUS + ZOMBIE_RADIUS = 60), então uma
+    // explosão que pega só o primeiro com profundidade N mata exatamente os
+    // N + 1 primeiros. O zumbi fora da fila nunca é alcançado.
+    {
+        const int rowLength = 8;
+        std::vector<sf::Vector2f> zombies;
+        for (int k = 0; k < rowLength; ++k) zombies.push_back(sf::Vector2f(200.f + 50.f * k, 600.f));
+        zombies.push_back(sf::Vector2f(200.f, 700.f));
+        for (int depth = 0; depth < rowLength - 1; ++depth) {
+            AreaEffect blast;
+            blast.position = zombies[0];
+            blast.radius = 30.f; // Não alcança o segundo da fila (50 > 30 + 12)
+            blast.chainDepth = depth;
+            blast.owner = OwnerPlayer1;
+            std::vector<bool> expected(zombies.size(), false);
+            for (int k = 0; k <= depth; ++k) expected[k] = true;
+            bool chainOk = detonate(blast, zombies) == expected;
+            ok = ok && chainOk;
+            std::printf("cadeia de profundidade %d: %s\n", depth,
+                        chainOk ? "mata exatamente os esperados" : "FALHA");
+        }
+    }
+    std::printf("%s\n", ok ? "OK: efeitos de area matam exatamente os zumbis esperados" : "FALHA");
+    return ok ? 0 : 1;
+}
+
+int runSnapshotCheck() {
+    JobSystem jobs;
+    jobs.init(0);
+
+    Simulation sim;
+    initSimulation(sim);
+    sim.jobs = &jobs;
+    startGame(sim, HEADLESS_SEED);
+
+    // Joga até o meio de uma partida, guardando snapshots no anel pelo caminho
+    const long long warmupTicks = 3000;
+    const long long checkTicks = 2000;
+    SnapshotRing ring;
+    ring.init(SNAPSHOT_RING_CAPACITY);
+    long long t = 0;
+    for (; t < warmupTicks; ++t) {
+        if (t % SNAPSHOT_INTERVAL_TICKS == 0) ring.push(sim, t);
+        stepSimulation(sim, scriptedInput(sim, t), HEADLESS_DT);
+    }
+
+    std::vector<unsigned char> bytes;
+    auto s0 = std::chrono::steady_clock::now();
+    saveSnapshot(sim, bytes);
+    auto s1 = std::chrono::steady_clock::now();
+
+    // Continua a partida anotando o hash de cada tick
+    std::vector<std::uint64_t> expected;
+    for (long long k = 0; k < checkTicks; ++k) {
+        stepSimulation(sim, scriptedInput(sim, t + k), HEADLESS_DT);
+        expected.push_back(hashSimulation(sim));
+    }
+    std::uint64_t finalHash = expected.back();
+
+    // Repete os mesmos ticks a partir de uma simulação restaurada
+    auto replayFrom = [&](Simulation& s, long long start, long long ticks) {
+        for (long long k = 0; k < ticks; ++k) {
+            stepSimulation(s, scriptedInput(s, start + k), HEADLESS_DT);
+            if (start + k >= t && hashSimulation(s) != expected[start + k - t]) return false;
+        }
+        return true;
+    };
+
+    auto l0 = std::chrono::steady_clock::now();
+    bool memoryOk = loadSnapshot(sim, bytes.data(), bytes.size());
+    auto l1 = std::chrono::steady_clock::now();
+    memoryOk = memoryOk && replayFrom(sim, t, checkTicks);
+
+    // Disco (arquivo mapeado), numa simulação nova
+    const char* path = "snapshot_check.snap";
+    Simulation fromDisk;
+    initSimulation(fromDisk);
+    fromDisk.jobs = &jobs;
+    bool diskOk = saveSnapshotFile(path, bytes) && loadSnapshotFile(path, fromDisk) &&
+                  replayFrom(fromDisk, t, checkTicks);
+    std::remove(path);
+
+    // Rewind: volta 20 snapshots e refaz até o fim
+    long long rewoundTick = 0;
+    bool ringOk = ring.rewind(sim, 20, rewoundTick) &&
+                  replayFrom(sim, rewoundTick, t + checkTicks - rewoundTick) &&
+                  hashSimulation(sim) == finalHash;
+
+    // Bytes que não são snapshot não podem mexer na simulação
+    std::vector<unsigned char> broken = bytes;
+    broken.resize(broken.size() / 2);
+    bool rejectOk = !loadSnapshot(sim, broken.data(), broken.size()) && hashSimulation(sim) == finalHash;
+
+    // Quickload de outra linha do tempo com a mesma barricadeVersion: as
+    // listas de barricadas por célula montadas depois do save não valem mais
+    bool cellsOk = false;
+    {
+        Simulation s;
+        initSimulation(s);
+        s.jobs = &jobs;
+        const sf::Vector2f a(400.f, 400.f), b(1200.f, 900.f);
+        std::vector<unsigned char> older, withA;
+        saveSnapshot(s, older);
+        s.barricades.add(makeBarricade(a));
+        s.barricadeVersion++;
+        saveSnapshot(s, withA);
+
+        // Outra linha do tempo chega à mesma versão com a barricada em outro lugar
+        loadSnapshot(s, older.data(), older.size());
+        s.barricades.add(makeBarricade(b));
+        s.barricadeVersion++;
+        s.zombies.push(b.x, b.y, ZOMBIE_RADIUS);
+        updateZombies(s, HEADLESS_DT);
+
+        // Um zumbi em cima de A precisa tocar A depois de voltar ao save
+        loadSnapshot(s, withA.data(), withA.size());
+        s.zombies.push(a.x, a.y, ZOMBIE_RADIUS);
+        updateZombies(s, HEADLESS_DT);
+        cellsOk = s.barricadeContact.size() == 1 && s.barricadeContact[0] == 0;
+    }
+
+    // Snapshots adulterados (barricada com mais vida que o máximo, a mesma
+    // bala em dois registros) não passam da verificação nem mexem na simulação
+    bool tamperOk = false;
+    {
+        Simulation s;
+        initSimulation(s);
+        const sf::Vector2f barPos(123.5f, 456.25f);
+        s.barricades.add(makeBarricade(barPos));
+        s.barricadeVersion++;
+        s.bullets.spawn(sf::Vector2f(300.f, 300.f), sf::Vector2f(BULLET_SPEED, 0.f), OwnerPlayer1);
+        s.bullets.spawn(sf::Vector2f(300.f, 320.f), sf::Vector2f(BULLET_SPEED, 0.f), OwnerPlayer2);
+        std::vector<unsigned char> clean;
+        saveSnapshot(s, clean);
+        std::uint64_t before = hashSimulation(s);
+
+        // Vida logo depois da posição da barricada
+        std::vector<unsigned char> badHealth = clean;
+        unsigned char posBytes[sizeof(barPos.x) * 2];
+        std::memcpy(posBytes, &barPos.x, sizeof(barPos.x));
+        std::memcpy(posBytes + sizeof(barPos.x), &barPos.y, sizeof(barPos.y));
+        auto at = std::search(badHealth.begin(), badHealth.end(), posBytes, posBytes + sizeof(posBytes));
+        bool found = at != badHealth.end();
+        if (found) {
+            int health = BARRIER_LIFE + 1;
+            std::memcpy(&*(at + sizeof(posBytes)), &health, sizeof(health));
+        }
+
+        // Registros de bala no fim: slot (u32), posição, velocidade, origem, dono
+        const size_t bulletRecord = sizeof(std::uint32_t) + 6 * sizeof(float) + 1;
+        std::vector<unsigned char> duplicateSlot = clean;
+        std::memcpy(&duplicateSlot[duplicateSlot.size() - bulletRecord],
+                    &duplicateSlot[duplicateSlot.size() - 2 * bulletRecord], sizeof(std::uint32_t));
+
+        tamperOk = found && loadSnapshot(s, clean.data(), clean.size()) &&
+                   !loadSnapshot(s, badHealth.data(), badHealth.size()) &&
+                   !loadSnapshot(s, duplicateSlot.data(), duplicateSlot.size()) &&
+                   hashSimulation(s) == before;
+    }
+
+    std::printf("zumbis/balas:        %zu / %d\n", sim.zombies.size(), sim.bullets.size());
+    std::printf("tamanho:             %zu bytes\n", bytes.size());
+    std::printf("salvar:              %.1f us\n", std::chrono::duration<double, std::micro>(s1 - s0).count());
+    std::printf("restaurar:           %.1f us\n", std::chrono::duration<double, std::micro>(l1 - l0).count());
+    std::printf("memoria:             %s\n", memoryOk ? "ok" : "FALHA");
+    std::printf("disco (mmap):        %s\n", diskOk ? "ok" : "FALHA");
+    std::printf("rewind (tick %lld):   %s\n", rewoundTick, ringOk ? "ok" : "FALHA");
+    std::printf("snapshot invalido:   %s\n", rejectOk ? "rejeitado" : "FALHA");
+    std::printf("barricadas por celula: %s\n", cellsOk ? "refeitas" : "FALHA");
+    std::printf("snapshot adulterado: %s\n", tamperOk ? "rejeitado" : "FALHA");
+
+    bool ok = memoryOk && diskOk && ringOk && rejectOk && cellsOk && tamperOk;
+    std::printf("%s\n", ok ? "OK: snapshots reproduzem a partida" : "FALHA");
+    return ok ? 0 : 1;
+}
+
+// Tempo médio, em nanossegundos por zumbi, de 'reps' chamadas de 'fn'
+template <typename Fn>
+static double nsPerZombie(size_t count, int reps, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) fn();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (static_cast<double>(reps) * count);
+}
+
+int runSimdBench() {
+    const SimdLevel best = detectSimdLevel();
+    std::printf("simd detectado: %s\n", simdLevelName(best));
+    std::printf("%8s %8s %12s %12s %12s %9s\n", "zumbis", "nivel", "mover ns/z", "circulo ns/z", "explosao ns/z", "ganho");
+
+    bool ok = true;
+    static const size_t counts[3] = { 1000, 10000, 100000 };
+    for (size_t count : counts) {
+        srand(12345);
+        std::vector<float> x0(count), y0(count), r(count), tx(count), ty(count);
+        for (size_t i = 0; i < count; ++i) {
+            x0[i] = static_cast<float>(rand() % WORLD_W);
+            y0[i] = static_cast<float>(rand() % WORLD_H);
+            r[i] = ZOMBIE_RADIUS;
+            tx[i] = x0[i] + static_cast<float>(rand() % 41 - 20);
+            ty[i] = y0[i] + static_cast<float>(rand() % 41 - 20);
+        }
+        const int reps = static_cast<int>(std::max<size_t>(1, 20000000 / count));
+
+        std::vector<float> x, y;
+        std::vector<float> refX, refY;
+        std::vector<char> hit(count), refHit;
+        size_t refHits = 0;
+        double scalarTotal = 0.0;
+
+        for (int level = SimdScalar; level <= best; ++level) {
+            setSimdLevel(static_cast<SimdLevel>(level));
+            x = x0;
+            y = y0;
+
+            double moveNs = nsPerZombie(count, reps, [&]() {
+                moveTowardsTargets(x.data(), y.data(), tx.data(), ty.data(), count, 0.5f);
+            });
+            // Círculo fora do mundo: nenhum acerto, o kernel percorre todos os zumbis
+            long sink = 0;
+            double circleNs = nsPerZombie(count, reps, [&]() {
+                sink += firstCircleOverlap(x.data(), y.data(), r.data(), count, -1000.f, -1000.f, 12.f);
+            });
+            size_t hits = 0;
+            double explosionNs = nsPerZombie(count, reps, [&]() {
+                hits = markCircleOverlaps(x.data(), y.data(), r.data(), count,
+                                          WORLD_W / 2.f, WORLD_H / 2.f, EXPLOSION_RADIUS, hit.data());
+            });
+
+            // Todas as versões precisam dar exatamente o mesmo resultado
+            if (level == SimdScalar) {
+                refX = x;
+                refY = y;
+                refHit = hit;
+                refHits = hits;
+                scalarTotal = moveNs + circleNs + explosionNs;
+            } else if (x != refX || y != refY || hit != refHit || hits != refHits || sink != -reps) {
+                std::printf("FALHA: %s difere do escalar com %zu zumbis\n",
+                            simdLevelName(static_cast<SimdLevel>(level)), count);
+                ok = false;
+            }
+
+            double total = moveNs + circleNs + explosionNs;
+            std::printf("%8zu %8s %12.3f %12.3f %12.3f %8.2fx\n", count, simdLevelName(static_cast<SimdLevel>(level)),
+                        moveNs, circleNs, explosionNs, scalarTotal / total);
+        }
+    }
+    setSimdLevel(best);
+    return ok ? 0 : 1;
+}
+
+// Zumbi-passos por segundo com 1, 2, 4... threads, conferindo que todas chegam ao mesmo hash
+int runJobScaling(long long zombies, int maxThreads) {
+    if (zombies <= 0) {
+        std::fprintf(stderr, "bench-jobs: numero de zumbis invalido\n");
+        return 1;
+    }
+
+    if (maxThreads <= 0) maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    const long long ticks = 120;
+    std::printf("zumbis: %lld, ticks: %lld, max threads: %d\n", zombies, ticks, maxThreads);
+    std::printf("%8s %16s %9s %18s\n", "threads", "zumbi-passos/s", "ganho", "hash");
+
+    double baseRate = 0.0;
+    unsigned long long firstHash = 0;
+    bool ok = true;
+    for (int threads : threadCounts) {
+        JobSystem jobs;
+        jobs.init(threads);
+
+        Simulation sim;
+        initSimulation(sim);
+        sim.jobs = &jobs;
+
+        // Wave que nunca termina, players fora do caminho
+        sim.currentWave = 1;
+        sim.zombiesToSpawn = 0;
+        sim.zombiesRemaining = static_cast<int>(zombies);
+        sim.player1.alive = false;
+        sim.player2.alive = false;
+
+        // Horda espalhada pelo mundo, longe da base, e um anel de barricadas
+        srand(12345);
+        sf::Vector2f basePos = sim.base.getPosition();
+        while (static_cast<long long>(sim.zombies.size()) < zombies) {
+            float zx = static_cast<float>(rand() % WORLD_W);
+            float zy = static_cast<float>(rand() % WORLD_H);
+            if (std::hypot(zx - basePos.x, zy - basePos.y) < 250.f) continue;
+            sim.zombies.push(zx, zy, ZOMBIE_RADIUS);
+        }
+        for (int k = 0; k < 32; ++k) {
+            float a = static_cast<float>(k) * 6.2831853f / 32.f;
+            sim.barricades.add(makeBarricade(basePos + sf::Vector2f(std::cos(a), std::sin(a)) * 200.f));
+        }
+        sim.barricadeVersion++;
+
+        TickInput idle;
+        auto start = std::chrono::steady_clock::now();
+        for (long long t = 0; t < ticks && !sim.gameOver; ++t) {
+            stepSimulation(sim, idle, HEADLESS_DT);
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        double rate = static_cast<double>(zombies) * ticks / elapsed.count();
+        if (threads == 1) baseRate = rate;
+        unsigned long long hash = hashSimulation(sim);
+        if (threads == threadCounts.front()) firstHash = hash;
+        else if (hash != firstHash) ok = false;
+
+        std::printf("%8d %16.0f %8.2fx %18llx\n", threads, rate, rate / baseRate, hash);
+    }
+
+    std::printf("%s\n", ok ? "OK: mesmo estado final com qualquer numero de threads" : "FALHA: estado final depende do numero de threads");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "simulation.hpp"
+
+// Modo headless: roda a simulação sem janela, com entradas de um bot roteirizado,
+// o mais rápido possível, e reporta ticks/s e latência por tick.
+// Uso: ./jogo --headless [ticks] [--record arquivo.rpl]  (grava a primeira partida)
+//      ./jogo --check-alloc   (falha se atirar alocar memória em regime)
+//      ./jogo --check-snapshot (falha se restaurar um snapshot muda a partida)
+//      ./jogo --check-tunneling (falha se uma bala atravessa um alvo com tick baixo)
+//      ./jogo --check-area    (falha se um cone ou uma cadeia de explosões mata os zumbis errados)
+//      ./jogo --bench-simd    (compara os kernels SIMD com o caminho escalar)
+//      ./jogo --bench-jobs [zumbis] [threads]  (zumbi-passos/s com 1, 2, 4... threads)
+
+// Passo fixo usado pelo modo headless (o mesmo tick do jogo com janela)
+const float HEADLESS_DT = 1.f / DEFAULT_TICK_RATE;
+
+// Semente da primeira partida headless (a partida n usa HEADLESS_SEED + n)
+const std::uint64_t HEADLESS_SEED = 12345;
+
+// Entradas roteirizadas do bot para o tick 'tick'
+TickInput scriptedInput(const Simulation& sim, long long tick);
+
+// Roda 'ticks' ticks da simulação e imprime o relatório. Com 'recordPath',
+// grava a primeira partida como replay. Retorna o código de saída.
+int runHeadless(long long ticks, const char* recordPath = nullptr);
+
+// Verifica que os players atirando sem parar não alocam memória depois do
+// aquecimento e que o pool de balas nunca transborda. Retorna 0 se passou
+// (só no jogo-check, que tem o contador de alocações).
+int runAllocCheck();
+
+// Atira balas contra zumbis e barricadas em todas as posições de um passo,
+// com 60, 20, 10 e 5 ticks/s, e confere que a colisão contínua acerta todos
+// (e só eles). Retorna 0 se passou.
+int runTunnelingCheck();
+
+// Detona um cone e explosões em cadeia de profundidade 0 a 6 sobre zumbis
+// em posições fixas e confere exatamente quais morreram. Retorna 0 se passou.
+int runAreaCheck();
+
+// Confere que restaurar um snapshot (da memória, do anel de rewind e do
+// disco) e repetir as entradas reproduz exatamente os mesmos ticks.
+// Retorna 0 se passou.
+int runSnapshotCheck();
+
+// Microbenchmark dos kernels SIMD (escalar x SSE x AVX2) com 1k, 10k e 100k
+// zumbis. Retorna 0 se todas as versões deram o mesmo resultado.
+int runSimdBench();
+
+// Mede zumbi-passos por segundo com uma horda de 'zombies' zumbis e 1, 2, 4...
+// threads até 'maxThreads' (<= 0 usa o número de núcleos). Retorna 0 se todas
+// as contagens de threads terminaram exatamente no mesmo estado.
+int runJobScaling(long long zombies, int maxThreads);
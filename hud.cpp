@@ -0,0 +1,202 @@
+#include "hud.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+void GlyphAtlas::init(const sf::Font& f, unsigned int size) {
+    font = &f;
+    characterSize = size;
+    // Pede todos os glifos agora: a página de textura não cresce durante o jogo
+    for (unsigned int c = 32; c < 127; ++c) {
+        glyphs[c] = f.getGlyph(c, size, false);
+    }
+}
+
+HudFormat& HudFormat::text(const char* s) {
+    while (*s && length < HUD_TEXT_CAPACITY) buffer[length++] = *s++;
+    return *this;
+}
+
+HudFormat& HudFormat::number(long long value) {
+    std::to_chars_result r = std::to_chars(buffer + length, buffer + HUD_TEXT_CAPACITY, value);
+    if (r.ec == std::errc()) length = static_cast<int>(r.ptr - buffer);
+    return *this;
+}
+
+HudFormat& HudFormat::fixed(double value, int decimals) {
+    long long scale = 1;
+    for (int d = 0; d < decimals; ++d) scale *= 10;
+    long long v = std::llround(value * scale);
+    if (v < 0) {
+        text("-");
+        v = -v;
+    }
+    number(v / scale);
+    if (decimals > 0) {
+        text(".");
+        long long frac = v % scale;
+        for (long long div = scale / 10; div > 0; div /= 10) {
+            char digit[2] = { static_cast<char>('0' + frac / div % 10), 0 };
+            text(digit);
+        }
+    }
+    return *this;
+}
+
+void Hud::init(const sf::Font& font, unsigned int characterSize) {
+    atlas.init(font, characterSize);
+    screenLabels.clear();
+    worldLabels.clear();
+    dirty = true;
+}
+
+int Hud::addScreenLabel(unsigned int size, sf::Vector2f anchor, sf::Color color) {
+    HudLabel label;
+    label.anchor = anchor;
+    label.scale = static_cast<float>(size) / atlas.characterSize;
+    label.color = color;
+    screenLabels.push_back(label);
+    dirty = true;
+    return static_cast<int>(screenLabels.size()) - 1;
+}
+
+bool Hud::assign(HudLabel& label, const HudFormat& f) {
+    if (label.length == f.length && std::memcmp(label.text, f.buffer, f.length) == 0) return false;
+    std::memcpy(label.text, f.buffer, f.length);
+    label.length = f.length;
+    return true;
+}
+
+void Hud::setText(int id, const HudFormat& f) {
+    if (assign(screenLabels[id], f)) dirty = true;
+}
+
+void Hud::setColor(int id, sf::Color color) {
+    if (screenLabels[id].color == color) return;
+    screenLabels[id].color = color;
+    dirty = true;
+}
+
+void Hud::setPosition(int id, sf::Vector2f position) {
+    if (screenLabels[id].position == position) return;
+    screenLabels[id].position = position;
+    dirty = true;
+}
+
+void Hud::setWorldLabelCount(size_t count, unsigned int size) {
+    if (worldLabels.size() == count) return;
+    HudLabel label;
+    label.anchor = sf::Vector2f(0.5f, 0.5f);
+    label.scale = static_cast<float>(size) / atlas.characterSize;
+    worldLabels.resize(count, label);
+    dirty = true;
+}
+
+void Hud::setWorldLabel(size_t i, const HudFormat& f, sf::Vector2f position) {
+    HudLabel& label = worldLabels[i];
+    if (assign(label, f)) dirty = true;
+    if (label.position != position) {
+        label.position = position;
+        dirty = true;
+    }
+}
+
+size_t Hud::quadCount(const HudLabel& label) const {
+    size_t quads = 0;
+    for (int k = 0; k < label.length; ++k) {
+        unsigned char c = static_cast<unsigned char>(label.text[k]);
+        if (c > 32 && c < 127) quads++;
+    }
+    return quads;
+}
+
+// Gera os quads de um texto a partir do vértice n, como o sf::Text faria
+// (linha de base em characterSize, kerning entre pares)
+void Hud::appendLabel(const HudLabel& label, size_t& n) {
+    const float size = static_cast<float>(atlas.characterSize);
+
+    // Mede o texto para aplicar a âncora
+    float width = 0.f;
+    float height = 0.f;
+    unsigned int prev = 0;
+    for (int k = 0; k < label.length; ++k) {
+        unsigned char c = static_cast<unsigned char>(label.text[k]);
+        if (c < 32 || c >= 127) continue;
+        if (prev) width += atlas.font->getKerning(prev, c, atlas.characterSize);
+        const sf::Glyph& g = atlas.glyphs[c];
+        if (c != ' ') height = std::max(height, size + g.bounds.top + g.bounds.height);
+        width += g.advance;
+        prev = c;
+    }
+    sf::Vector2f origin(label.anchor.x * width, label.anchor.y * height);
+
+    float penX = 0.f;
+    prev = 0;
+    for (int k = 0; k < label.length; ++k) {
+        unsigned char c = static_cast<unsigned char>(label.text[k]);
+        if (c < 32 || c >= 127) continue;
+        if (prev) penX += atlas.font->getKerning(prev, c, atlas.characterSize);
+        prev = c;
+        const sf::Glyph& g = atlas.glyphs[c];
+        if (c == ' ') {
+            penX += g.advance;
+            continue;
+        }
+
+        float left = (penX + g.bounds.left - origin.x) * label.scale + label.position.x;
+        float top = (size + g.bounds.top - origin.y) * label.scale + label.position.y;
+        float right = left + g.bounds.width * label.scale;
+        float bottom = top + g.bounds.height * label.scale;
+
+        float u0 = static_cast<float>(g.textureRect.left);
+        float v0 = static_cast<float>(g.textureRect.top);
+        float u1 = u0 + g.textureRect.width;
+        float v1 = v0 + g.textureRect.height;
+
+        sf::Vertex* v = &vertices[n];
+        v[0] = sf::Vertex(sf::Vector2f(left, top), label.color, sf::Vector2f(u0, v0));
+        v[1] = sf::Vertex(sf::Vector2f(right, top), label.color, sf::Vector2f(u1, v0));
+        v[2] = sf::Vertex(sf::Vector2f(right, bottom), label.color, sf::Vector2f(u1, v1));
+        v[3] = v[0];
+        v[4] = v[2];
+        v[5] = sf::Vertex(sf::Vector2f(left, bottom), label.color, sf::Vector2f(u0, v1));
+        n += 6;
+        penX += g.advance;
+    }
+}
+
+void Hud::update(const sf::View& view) {
+    sf::Vector2f origin = view.getCenter() - view.getSize() / 2.f;
+
+    if (dirty) {
+        size_t quads = 0;
+        for (const HudLabel& label : screenLabels) quads += quadCount(label);
+        size_t screenVertices = quads * 6;
+        for (const HudLabel& label : worldLabels) quads += quadCount(label);
+        vertices.resize(quads * 6);
+
+        // Textos de tela primeiro, guardados sem o deslocamento da câmera
+        size_t n = 0;
+        for (const HudLabel& label : screenLabels) appendLabel(label, n);
+        screenLocal.resize(screenVertices);
+        for (size_t i = 0; i < screenVertices; ++i) screenLocal[i] = vertices[i].position;
+        for (const HudLabel& label : worldLabels) appendLabel(label, n);
+
+        dirty = false;
+        rebuilds++;
+        screenOrigin = sf::Vector2f(0.f, 0.f);
+    }
+
+    // Câmera mexeu: só os textos de tela andam junto
+    if (origin != screenOrigin) {
+        for (size_t i = 0; i < screenLocal.size(); ++i) vertices[i].position = screenLocal[i] + origin;
+        screenOrigin = origin;
+    }
+}
+
+void Hud::draw(DrawCounter& out) const {
+    if (vertices.getVertexCount() == 0) return;
+    out.draw(vertices, sf::RenderStates(&atlas.texture()));
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+#include "render.hpp"
+
+// HUD em modo retido: os textos do HUD e os números de vida das barricadas são
+// quads de um único sf::VertexArray, desenhados numa só chamada com a textura
+// de glifos da fonte. A geometria só é refeita quando algum texto, cor ou
+// posição muda de fato; mover a câmera só desloca os vértices dos textos
+// presos à tela. Números são formatados num buffer fixo (std::to_chars), sem
+// std::stringstream nem std::string.
+
+// Tamanho máximo de um texto do HUD (o resto é cortado)
+const int HUD_TEXT_CAPACITY = 64;
+
+// Glifos ASCII imprimíveis da fonte num único tamanho, rasterizados uma vez
+// em init(). Todos ficam na mesma página de textura da fonte; tamanhos menores
+// são desenhados com escala.
+struct GlyphAtlas {
+    const sf::Font* font = nullptr;
+    unsigned int characterSize = 0;
+    sf::Glyph glyphs[128];
+
+    void init(const sf::Font& f, unsigned int size);
+    const sf::Texture& texture() const { return font->getTexture(characterSize); }
+};
+
+// Monta um texto curto num buffer fixo, sem alocar
+struct HudFormat {
+    char buffer[HUD_TEXT_CAPACITY];
+    int length = 0;
+
+    HudFormat& text(const char* s);
+    HudFormat& number(long long value);
+    HudFormat& fixed(double value, int decimals); // Ponto fixo, ex.: fixed(1.5, 2) -> "1.50"
+};
+
+// Um texto do HUD. 'anchor' é o ponto do texto (0..1 na largura e na altura)
+// que fica em 'position'.
+struct HudLabel {
+    char text[HUD_TEXT_CAPACITY];
+    int length = 0;
+    sf::Vector2f position;
+    sf::Vector2f anchor;
+    float scale = 1.f;
+    sf::Color color = sf::Color::White;
+};
+
+struct Hud {
+    GlyphAtlas atlas;
+    std::vector<HudLabel> screenLabels; // Posição relativa ao canto superior esquerdo da view
+    std::vector<HudLabel> worldLabels;  // Posição no mundo (vida das barricadas)
+
+    sf::VertexArray vertices{sf::Triangles};
+    std::vector<sf::Vector2f> screenLocal; // Vértices dos textos de tela antes do deslocamento da câmera
+    sf::Vector2f screenOrigin;             // Canto superior esquerdo da view usado no último deslocamento
+    bool dirty = true;
+    int rebuilds = 0; // Quantas vezes a geometria foi refeita (estatística)
+
+    // 'characterSize' é o tamanho rasterizado; use o maior tamanho do HUD
+    void init(const sf::Font& font, unsigned int characterSize);
+
+    // Cria um texto preso à tela com o tamanho de fonte 'size'; devolve o id
+    int addScreenLabel(unsigned int size, sf::Vector2f anchor, sf::Color color);
+
+    // Setters só marcam o HUD como sujo se o valor mudou
+    void setText(int id, const HudFormat& f);
+    void setColor(int id, sf::Color color);
+    void setPosition(int id, sf::Vector2f position);
+
+    // Textos no mundo: ajusta a quantidade e define cada um (tamanho 'size', centrado)
+    void setWorldLabelCount(size_t count, unsigned int size);
+    void setWorldLabel(size_t i, const HudFormat& f, sf::Vector2f position);
+
+    // Refaz a geometria se algo mudou e desloca os textos de tela para a view atual
+    void update(const sf::View& view);
+
+    // Uma chamada de desenho para todo o HUD (na view do jogo)
+    void draw(DrawCounter& out) const;
+
+private:
+    static bool assign(HudLabel& label, const HudFormat& f);
+    void appendLabel(const HudLabel& label, size_t& n);
+    size_t quadCount(const HudLabel& label) const;
+};
@@ -0,0 +1,135 @@
+#include "job_system.hpp"
+
+#include <algorithm>
+
+// Pedaços por thread em cada parallelFor: um pouco mais que um, para que quem
+// terminar antes tenha o que roubar
+static const size_t CHUNKS_PER_THREAD = 4;
+static const size_t QUEUE_CAPACITY = 64;
+
+bool JobSystem::WorkQueue::pushBack(const Job& job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count == ring.size()) return false;
+    ring[(head + count) % ring.size()] = job;
+    count++;
+    return true;
+}
+
+bool JobSystem::WorkQueue::popBack(Job& job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count == 0) return false;
+    count--;
+    job = ring[(head + count) % ring.size()];
+    return true;
+}
+
+bool JobSystem::WorkQueue::stealFront(Job& job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count == 0) return false;
+    job = ring[head];
+    head = (head + 1) % ring.size();
+    count--;
+    return true;
+}
+
+void JobSystem::init(int threads) {
+    shutdown();
+    if (threads <= 0) threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    stopping = false;
+    for (int t = 0; t < threads; ++t) {
+        queues.emplace_back(new WorkQueue());
+        queues.back()->ring.resize(QUEUE_CAPACITY);
+    }
+    for (int t = 1; t < threads; ++t) {
+        workers.emplace_back(&JobSystem::workerLoop, this, static_cast<size_t>(t));
+    }
+}
+
+void JobSystem::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& w : workers) w.join();
+    workers.clear();
+    queues.clear();
+}
+
+void JobSystem::execute(const Job& job) {
+    job.run(job.ctx, job.begin, job.end);
+    job.pending->fetch_sub(1, std::memory_order_acq_rel);
+}
+
+bool JobSystem::tryGetJob(size_t self, Job& job) {
+    const size_t n = queues.size();
+    bool found = queues[self]->popBack(job);
+    for (size_t k = 1; !found && k < n; ++k) {
+        found = queues[(self + k) % n]->stealFront(job);
+    }
+    if (found) queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    return found;
+}
+
+void JobSystem::dispatch(size_t count, size_t grain, void (*run)(void*, size_t, size_t), void* ctx) {
+    if (count == 0) return;
+    grain = std::max<size_t>(1, grain);
+    const size_t threads = std::max<size_t>(1, queues.size());
+
+    size_t chunks = std::min((count + grain - 1) / grain, threads * CHUNKS_PER_THREAD);
+    if (chunks <= 1 || threads == 1) {
+        run(ctx, 0, count);
+        return;
+    }
+
+    std::atomic<size_t> pending{chunks};
+    const size_t chunkSize = (count + chunks - 1) / chunks;
+    for (size_t c = 0; c < chunks; ++c) {
+        Job job;
+        job.run = run;
+        job.ctx = ctx;
+        job.begin = c * chunkSize;
+        job.end = std::min(count, job.begin + chunkSize);
+        job.pending = &pending;
+        if (job.begin >= job.end) {
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            continue;
+        }
+        queuedJobs.fetch_add(1, std::memory_order_relaxed);
+        if (!queues[c % threads]->pushBack(job)) {
+            // Fila cheia: a própria thread executa o pedaço
+            queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            execute(job);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wake.notify_all();
+
+    // Quem chamou também trabalha até todos os pedaços acabarem
+    Job job;
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (tryGetJob(0, job)) {
+            execute(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::workerLoop(size_t self) {
+    Job job;
+    for (;;) {
+        if (tryGetJob(self, job)) {
+            execute(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this]() {
+            return stopping || queuedJobs.load(std::memory_order_relaxed) > 0;
+        });
+        if (stopping) return;
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Sistema de jobs pequeno para dividir laços por entidade entre os núcleos.
+// Cada thread (a que chama parallelFor é a fila 0, os workers são as demais)
+// tem sua própria fila: a dona tira do fim, as outras roubam do começo quando
+// a delas esvazia. As filas têm capacidade fixa, então despachar jobs não aloca
+// memória. parallelFor bloqueia até todos os pedaços terminarem e não pode ser
+// chamado de dentro de um job.
+struct JobSystem {
+    struct Job {
+        void (*run)(void* ctx, size_t begin, size_t end) = nullptr;
+        void* ctx = nullptr;
+        size_t begin = 0;
+        size_t end = 0;
+        std::atomic<size_t>* pending = nullptr;
+    };
+
+    // Deque de capacidade fixa protegido por mutex
+    struct WorkQueue {
+        std::mutex mutex;
+        std::vector<Job> ring;
+        size_t head = 0; // Próximo a ser roubado
+        size_t count = 0;
+
+        bool pushBack(const Job& job);
+        bool popBack(Job& job);    // Usado pela dona da fila
+        bool stealFront(Job& job); // Usado pelas outras threads
+    };
+
+    JobSystem() = default;
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    ~JobSystem() { shutdown(); }
+
+    // Sobe 'threads' - 1 workers (a thread que chama conta como uma).
+    // threads <= 0 usa todos os núcleos da máquina.
+    void init(int threads);
+    void shutdown();
+
+    // Threads que executam jobs, incluindo a que chama parallelFor
+    int threadCount() const { return static_cast<int>(queues.size()); }
+
+    // Chama fn(begin, end) para pedaços de [0, count) de pelo menos 'grain'
+    // itens, espalhados pelas threads. Cada pedaço é um intervalo contíguo e
+    // disjunto, então escrever só nos índices do próprio pedaço é seguro.
+    template <typename Fn>
+    void parallelFor(size_t count, size_t grain, Fn&& fn) {
+        typedef typename std::decay<Fn>::type F;
+        dispatch(count, grain, &invoke<F>, const_cast<void*>(static_cast<const void*>(&fn)));
+    }
+
+private:
+    template <typename F>
+    static void invoke(void* ctx, size_t begin, size_t end) {
+        (*static_cast<F*>(ctx))(begin, end);
+    }
+
+    void dispatch(size_t count, size_t grain, void (*run)(void*, size_t, size_t), void* ctx);
+    bool tryGetJob(size_t self, Job& job);
+    static void execute(const Job& job);
+    void workerLoop(size_t self);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<size_t> queuedJobs{0};
+    bool stopping = false;
+};
@@ -1,12 +1,30 @@
 #include <SFML/Graphics.hpp>
 #include <cmath>
-#include <vector>
 #include <algorithm>
-#include <limits>
-#include <cstdlib> // Para números aleatórios (rand)
-#include <ctime>   // Para a semente de números aleatórios (time)
+#include <cstdlib>
+#include <ctime>   // Para a semente das partidas (time)
 #include <string>  // Para o texto
-#include <sstream> // Para converter int para string
+#include <cstring>
+#include <cstdio>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "simulation.hpp"
+#include "headless.hpp"
+#include "render.hpp"
+#include "hud.hpp"
+#include "profiler.hpp"
+#include "profiler_overlay.hpp"
+#include "fixed_step.hpp"
+#include "replay.hpp"
+#include "sweep.hpp"
+#include "snapshot.hpp"
+#include "net.hpp"
+#include "assets.hpp"
+#include "particles.hpp"
+#include "render_snapshot.hpp"
+#include "triple_buffer.hpp"
 
 // M_PI não é padrão C++, mas geralmente está disponível ou pode ser definido
 #ifndef M_PI
@@ -21,163 +39,146 @@ enum GameState {
     GameOverScreen
 };
 
-// Estrutura da Bala
-struct Bullet {
-    sf::CircleShape shape;
-    sf::Vector2f velocity;
+// Comandos da renderização para a thread da simulação (bits que se juntam
+// até a simulação ler)
+enum SimCommand : unsigned {
+    CommandBeginGame = 1u << 0, // Partida nova
+    CommandMenu = 1u << 1,      // Volta ao menu (encerra a partida)
+    CommandPause = 1u << 2,
+    CommandResume = 1u << 3,
+    CommandQuicksave = 1u << 4,
+    CommandQuickload = 1u << 5,
+    CommandRewind = 1u << 6,
+    CommandP1Ability = 1u << 7,
+    CommandP2Ability = 1u << 8
 };
 
-// Estrutura do Zumbi (com sf::Sprite e float radius)
-struct Zombie {
-    sf::Sprite sprite; 
-    float radius;      
-};
-
-// Estrutura da Barricada (para Player 2)
-struct Barricade {
-    sf::RectangleShape shape;
-    int health;
-    int maxHealth; // NOVO: Para exibir x/y vida
-    sf::Text healthText; // NOVO: Para exibir a vida
-};
-
-// NOVO: Estrutura da Explosão (para Player 1)
-struct Explosion {
-    sf::CircleShape shape;
-    sf::Vector2f position;
-    float currentRadius;
-    float maxRadius;
-    float expandSpeed;
-    float fadeSpeed;
-    bool active;
-    bool damageDealt; // Para garantir que o dano é aplicado apenas uma vez
-};
-
-// Função para verificar colisão entre dois círculos
-bool checkCircleCollision(sf::Vector2f p1, float r1, sf::Vector2f p2, float r2) {
-    float dx = p1.x - p2.x;
-    float dy = p1.y - p2.y;
-    float distanceSquared = dx * dx + dy * dy;
-    float radiusSum = r1 + r2;
-    return distanceSquared < (radiusSum * radiusSum);
+// Limites de frames da janela: cheio com a cena se mexendo, reduzido com ela
+// parada há QUIET_DELAY segundos ou com a janela sem foco (menus e pause
+// nem redesenham; esperam o próximo evento)
+const unsigned FRAME_RATE_ACTIVE = 144;
+const unsigned FRAME_RATE_QUIET = 30;
+const float QUIET_DELAY = 0.5f;
+
+// Lê o estado atual do teclado para um player (teclas de movimento e tiro)
+static PlayerInput readPlayerInput(sf::Keyboard::Key up, sf::Keyboard::Key down,
+                                   sf::Keyboard::Key left, sf::Keyboard::Key right,
+                                   sf::Keyboard::Key shoot) {
+    PlayerInput in;
+    in.up = sf::Keyboard::isKeyPressed(up);
+    in.down = sf::Keyboard::isKeyPressed(down);
+    in.left = sf::Keyboard::isKeyPressed(left);
+    in.right = sf::Keyboard::isKeyPressed(right);
+    in.shoot = sf::Keyboard::isKeyPressed(shoot);
+    return in;
 }
 
-// Função para verificar colisão entre círculo e retângulo
-bool checkCircleRectCollision(sf::Vector2f circlePos, float circleRadius,
-                              sf::Vector2f rectPos, sf::Vector2f rectSize) {
-    // A posição do shape do retângulo é o centro devido ao setOrigin
-    float halfRectW = rectSize.x / 2.0f;
-    float halfRectH = rectSize.y / 2.0f;
 
-    float rectLeft = rectPos.x - halfRectW;
-    float rectRight = rectPos.x + halfRectW;
-    float rectTop = rectPos.y - halfRectH;
-    float rectBottom = rectPos.y + halfRectH;
-
-    float testX = circlePos.x;
-    float testY = circlePos.y;
-
-    if (circlePos.x < rectLeft)         testX = rectLeft;
-    else if (circlePos.x > rectRight) testX = rectRight;
-
-    if (circlePos.y < rectTop)         testY = rectTop;
-    else if (circlePos.y > rectBottom) testY = rectBottom;
-
-    float distX = circlePos.x - testX;
-    float distY = circlePos.y - testY;
-    float distanceSquared = (distX * distX) + (distY * distY);
+int main(int argc, char* argv[]) {
+    // Gravação de replay (--record arquivo.rpl): a última partida jogada vai para o arquivo
+    const char* recordPath = nullptr;
+    for (int a = 1; a + 1 < argc; ++a) {
+        if (std::strcmp(argv[a], "--record") == 0) recordPath = argv[a + 1];
+    }
 
-    return distanceSquared < (circleRadius * circleRadius);
-}
+    // Modo headless: roda só a simulação, sem abrir janela
+    if (argc > 1 && std::strcmp(argv[1], "--headless") == 0) {
+        long long ticks = argc > 2 && argv[2][0] != '-' ? std::atoll(argv[2]) : 100000;
+        return runHeadless(ticks, recordPath);
+    }
+    if (argc > 2 && std::strcmp(argv[1], "--replay") == 0) {
+        return runReplay(argv[2]);
+    }
+    if (argc > 2 && std::strcmp(argv[1], "--sweep") == 0) {
+        return runSweep(argv[2], argc > 3 ? argv[3] : "sweep.csv");
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--check-alloc") == 0) {
+        return runAllocCheck();
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--check-snapshot") == 0) {
+        return runSnapshotCheck();
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--check-tunneling") == 0) {
+        return runTunnelingCheck();
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--check-area") == 0) {
+        return runAreaCheck();
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench-simd") == 0) {
+        return runSimdBench();
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench-jobs") == 0) {
+        long long zombies = argc > 2 ? std::atoll(argv[2]) : 100000;
+        int threads = argc > 3 ? std::atoi(argv[3]) : 0;
+        return runJobScaling(zombies, threads);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--server-headless") == 0) {
+        unsigned short port = argc > 2 ? static_cast<unsigned short>(std::atoi(argv[2])) : NET_DEFAULT_PORT;
+        long long ticks = argc > 3 ? std::atoll(argv[3]) : 60LL * DEFAULT_TICK_RATE;
+        int zombies = argc > 4 ? std::atoi(argv[4]) : 0;
+        return runNetServerHeadless(port, ticks, zombies);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--client-headless") == 0) {
+        sf::IpAddress address(argc > 2 ? argv[2] : "127.0.0.1");
+        unsigned short port = argc > 3 ? static_cast<unsigned short>(std::atoi(argv[3])) : NET_DEFAULT_PORT;
+        long long ticks = argc > 4 ? std::atoll(argv[4]) : 60LL * DEFAULT_TICK_RATE;
+        return runNetClientHeadless(address, port, ticks);
+    }
 
+    // Co-op em rede: --server [porta] hospeda (P1 local, P2 remoto), --client [ip] [porta] joga o P2
+    bool netServer = argc > 1 && std::strcmp(argv[1], "--server") == 0;
+    bool netClient = argc > 1 && std::strcmp(argv[1], "--client") == 0;
+    NetServer server;
+    NetClient client;
+    if (netServer) {
+        unsigned short port = argc > 2 && argv[2][0] != '-' ? static_cast<unsigned short>(std::atoi(argv[2])) : NET_DEFAULT_PORT;
+        if (!server.start(port)) {
+            std::fprintf(stderr, "servidor: nao foi possivel abrir a porta %u\n", port);
+            return 1;
+        }
+        std::printf("servidor: esperando o P2 na porta %u\n", port);
+    }
+    if (netClient) {
+        sf::IpAddress address(argc > 2 && argv[2][0] != '-' ? argv[2] : "127.0.0.1");
+        unsigned short port = argc > 3 && argv[3][0] != '-' ? static_cast<unsigned short>(std::atoi(argv[3])) : NET_DEFAULT_PORT;
+        if (!client.start(address, port)) {
+            std::fprintf(stderr, "cliente: nao foi possivel abrir o socket\n");
+            return 1;
+        }
+    }
+    long long netTicks = 0; // Ticks jogados em rede (para a banda por tick)
 
-// Variáveis globais do estado da wave
-int currentWave = 0;
-int zombiesToSpawn = 0;
-int zombiesSpawnedThisWave = 0;
-int zombiesRemaining = 0;
-const int INITIAL_ZOMBIES = 10;
-const int ZOMBIE_INCREMENT_PER_WAVE = 5;
-
-// Variáveis globais para o sistema de poderes
-// Clocks para o cooldown
-sf::Clock p1AbilityCooldownClock;
-sf::Clock p2AbilityCooldownClock;
-
-// NOVO: Variável da Explosão
-Explosion p1Explosion;
-
-std::vector<Barricade> barricades; // Vetor para armazenar as barricadas
-
-// Função para reiniciar o jogo (apenas estado do jogo, sem reiniciar cooldowns/habilidades)
-void resetGame(bool& p1Alive, bool& p2Alive,
-               sf::CircleShape& player1, sf::CircleShape& player2,
-               sf::RectangleShape& base, 
-               std::vector<Zombie>& zombies, std::vector<Bullet>& bullets,
-               sf::Clock& spawnClock, unsigned int worldW, unsigned int worldH) 
-{
-    p1Alive = true;
-    p2Alive = true;
-    
-    player1.setPosition(worldW / 3.0f, worldH / 2.0f);
-    player2.setPosition(2 * worldW / 3.0f, worldH / 2.0f);
-    base.setPosition(worldW / 2.0f, worldH / 2.0f); 
-    
-    zombies.clear();
-    bullets.clear();
-    spawnClock.restart();
-
-    // Reseta variáveis do sistema de waves
-    currentWave = 0; 
-    zombiesToSpawn = 0; 
-    zombiesSpawnedThisWave = 0;
-    zombiesRemaining = 0;
-
-    // Apenas limpa barricadas e reseta explosão, cooldowns são reiniciados apenas na transição de estado
-    barricades.clear();
-    p1Explosion.active = false;
-    p1Explosion.damageDealt = false;
-}
+    // Ticks por segundo da simulação (--tick-rate N); o limite de FPS só afeta a apresentação
+    int tickRate = DEFAULT_TICK_RATE;
+    for (int a = 1; a + 1 < argc; ++a) {
+        if (std::strcmp(argv[a], "--tick-rate") == 0) {
+            tickRate = std::max(1, std::atoi(argv[a + 1]));
+        }
+    }
 
-// Função para iniciar a próxima wave
-void startNextWave() {
-    currentWave++;
-    zombiesToSpawn = INITIAL_ZOMBIES + (currentWave - 1) * ZOMBIE_INCREMENT_PER_WAVE;
-    zombiesSpawnedThisWave = 0;
-    zombiesRemaining = zombiesToSpawn; 
-}
+    // Profiler por fase (--profile [arquivo.csv] já começa coletando; F3 mostra o overlay)
+    bool profileFromStart = false;
+    const char* profileCsvPath = "profile.csv";
+    for (int a = 1; a < argc; ++a) {
+        if (std::strcmp(argv[a], "--profile") == 0) {
+            profileFromStart = true;
+            if (a + 1 < argc && argv[a + 1][0] != '-') profileCsvPath = argv[a + 1];
+        }
+    }
+    g_profiler.setEnabled(profileFromStart);
 
+    // Cada partida tem sua semente, gravada no replay junto com as entradas
+    std::uint64_t nextSeed = static_cast<std::uint64_t>(time(0));
 
-int main() {
-    srand(static_cast<unsigned>(time(0)));
+    // Tempo de inicialização (janela, assets, glifos) e do primeiro frame, impressos no terminal
+    sf::Clock startupClock;
 
-    // Configurações da Janela e Mundo
+    // Configurações da Janela (as do mundo e do jogo estão em simulation.hpp)
     const unsigned int WINDOW_W = 800; 
     const unsigned int WINDOW_H = 600; 
-    const unsigned int WORLD_W = 1600; 
-    const unsigned int WORLD_H = 1200; 
-
-    // Constantes do Jogo
-    const float SPEED = 300.0f;
-    const float BULLET_SPEED = 600.0f; 
-    const float ZOMBIE_SPEED = 60.0f; 
-    const float ZOMBIE_SPAWN_TIME = 0.5f; 
-    const float BULLET_RADIUS = 5.f; 
-    const float BULLET_RATE = 200; 
-    
-    // Cooldowns das Habilidades (em segundos)
-    const float PLAYER1_ABILITY_COOLDOWN = 10.0f; 
-    const float PLAYER2_ABILITY_COOLDOWN = 10.0f; 
-
-    // NOVO: Constantes de Habilidade
-    const int BARRIER_LIFE = 500; // Vida inicial da barricada
-    const sf::Vector2f BARRICADE_SIZE = {40.f, 40.f}; // Tamanho da barricada (AGORA UM QUADRADO)
-    const float EXPLOSION_RADIUS = 150.f; // Raio máximo da explosão
-    const float EXPLOSION_EXPAND_SPEED = 500.f; // Velocidade de expansão da explosão
-    const float EXPLOSION_FADE_SPEED = 200.f; // Velocidade de desvanecimento da explosão
 
     sf::RenderWindow window(sf::VideoMode(WINDOW_W, WINDOW_H), "SFML Zomboid");
-    window.setFramerateLimit(144);
+    window.setFramerateLimit(FRAME_RATE_ACTIVE);
 
     // Câmera (View)
     sf::View gameView(sf::FloatRect(0, 0, (float)WINDOW_W, (float)WINDOW_H));
@@ -187,15 +188,12 @@ int main() {
     sf::RectangleShape background(sf::Vector2f((float)WORLD_W, (float)WORLD_H));
     background.setFillColor(sf::Color(40, 40, 40)); 
 
-    // Base Central
-    sf::RectangleShape base(sf::Vector2f(24.f, 24.f)); 
-    base.setFillColor(sf::Color::Yellow);
-    base.setOrigin(12.f, 12.f);
-    base.setPosition(WORLD_W / 2.0f, WORLD_H / 2.0f); 
+    sf::Time windowTime = startupClock.getElapsedTime();
 
-    // Carrega Fonte
+    // Carrega Fonte (embutida no executável)
     sf::Font font;
-    if (!font.loadFromFile("zombie.otf")) { 
+    EmbeddedAsset fontAsset = embeddedFont();
+    if (!font.loadFromMemory(fontAsset.data, fontAsset.size)) { 
         return -1; 
     }
 
@@ -228,17 +226,6 @@ int main() {
     gameOverText.setOrigin(goTextRect.left + goTextRect.width / 2.0f, goTextRect.top + goTextRect.height / 2.0f);
     gameOverText.setPosition(WINDOW_W / 2.0f, WINDOW_H / 2.0f); 
 
-    // Textos do HUD (Wave e Zumbis)
-    sf::Text waveText;
-    waveText.setFont(font);
-    waveText.setCharacterSize(30);
-    waveText.setFillColor(sf::Color::White);
-
-    sf::Text zombiesRemainingText;
-    zombiesRemainingText.setFont(font);
-    zombiesRemainingText.setCharacterSize(25);
-    zombiesRemainingText.setFillColor(sf::Color::White);
-
     // Texto para a tela de Pause
     sf::Text pausedText;
     pausedText.setFont(font);
@@ -280,596 +267,743 @@ int main() {
     sf::FloatRect exitGameTextRect = exitGameText.getLocalBounds();
     exitGameText.setOrigin(exitGameTextRect.left + exitGameTextRect.width / 2.0f, exitGameTextRect.top + exitGameTextRect.height / 2.0f);
 
-    // Textos para o Cooldown das Habilidades
-    sf::Text p1AbilityCooldownText;
-    p1AbilityCooldownText.setFont(font);
-    p1AbilityCooldownText.setCharacterSize(20);
-    p1AbilityCooldownText.setFillColor(sf::Color::Red);
-
-    sf::Text p2AbilityCooldownText;
-    p2AbilityCooldownText.setFont(font);
-    p2AbilityCooldownText.setCharacterSize(20);
-    p2AbilityCooldownText.setFillColor(sf::Color::Blue);
-
-    // Carrega Textura do Zumbi
-    sf::Texture zombieTexture;
-    if (!zombieTexture.loadFromFile("zombie.png")) {
+    // HUD (wave, zumbis, cooldowns e vida das barricadas): um único lote de glifos
+    Hud hud;
+    hud.init(font, 30);
+    const int waveLabel = hud.addScreenLabel(30, sf::Vector2f(0.5f, 0.5f), sf::Color::White);
+    const int zombiesLabel = hud.addScreenLabel(25, sf::Vector2f(0.5f, 0.5f), sf::Color::White);
+    const int p1AbilityLabel = hud.addScreenLabel(20, sf::Vector2f(0.f, 0.5f), sf::Color::Red);   // Canto inferior esquerdo
+    const int p2AbilityLabel = hud.addScreenLabel(20, sf::Vector2f(1.f, 0.5f), sf::Color::Blue);  // Canto inferior direito
+
+    // Atlas com todos os sprites (zumbi e o texel branco das balas)
+    SpriteAtlas atlas;
+    if (!atlas.build()) {
         return -1; 
     }
-
-    // Players
-    sf::CircleShape player1(12.0f);
-    player1.setFillColor(sf::Color::Red); 
-    player1.setOrigin(player1.getRadius(), player1.getRadius());
-    
-    sf::CircleShape player2(12.0f);
-    player2.setFillColor(sf::Color::Blue);
-    player2.setOrigin(player2.getRadius(), player2.getRadius());
-    
-    // Vetores
-    std::vector<Bullet> bullets;
-    std::vector<Zombie> zombies;
-    
-    // Clocks
+    sf::Time assetsTime = startupClock.getElapsedTime();
+
+    // Glifos de todos os tamanhos de texto rasterizados agora, não no primeiro frame que os usa
+    int warmedGlyphs = warmGlyphs(font, GAME_TEXT_SIZES, sizeof(GAME_TEXT_SIZES) / sizeof(GAME_TEXT_SIZES[0]));
+    sf::Time glyphsTime = startupClock.getElapsedTime();
+
+    // Renderização em lote de zumbis e balas
+    BatchRenderer batch;
+
+    // Estatística de chamadas de desenho, mostrada no título da janela
+    sf::Clock drawStatsClock;
+    int lastDrawCalls = -1;
+
+    // Entidades desenhadas e descartadas pelo culling no frame (também no título)
+    CullStats cullStats;
+    CullStats lastCullStats;
+
+    // Estado da simulação (players, zumbis, balas, barricadas, efeitos e waves).
+    // Depois que a thread da simulação sobe, só ela mexe em 'sim' (e na
+    // gravação, nos snapshots e na rede); a renderização só lê as fotos que
+    // ela publica.
+    // Threads para os laços por zumbi (todos os núcleos)
+    JobSystem jobs;
+    jobs.init(0);
+
+    // Outro sistema de jobs para montar os lotes na thread de renderização
+    // (parallelFor aceita uma thread chamando por vez)
+    JobSystem renderJobs;
+    renderJobs.init(std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / 2));
+
+    Simulation sim;
+    initSimulation(sim);
+    sim.jobs = &jobs;
+
+    // Formas só de desenho, com as cores e tamanhos de initSimulation
+    sf::CircleShape playerShapes[2] = { sim.player1.shape, sim.player2.shape };
+    sf::RectangleShape baseShape = sim.base;
+    sf::RectangleShape barricadeShape = makeBarricade(sf::Vector2f()).shape;
+
+    // Overlay do profiler (F3)
+    ProfilerOverlay profilerOverlay;
+    profilerOverlay.init(font);
+    bool showProfiler = false;
+
+    // Clock do frame (partículas) e passo fixo da simulação (da thread dela)
     sf::Clock clock;
-    sf::Clock shootClock1;
-    sf::Clock shootClock2;
-    sf::Clock zombieSpawnClock; 
-
-    // Últimas direções
-    sf::Vector2f lastDir1 = {0.f, -1.f};
-    sf::Vector2f lastDir2 = {0.f, -1.f};
-
-    // Estados dos Players
-    bool player1Alive = true;
-    bool player2Alive = true;
-
-    // Estado inicial do Jogo
-    GameState currentState = MainMenu;
-
-    // Inicializa a explosão do P1
-    p1Explosion.active = false;
-    p1Explosion.currentRadius = 0.f;
-    p1Explosion.maxRadius = EXPLOSION_RADIUS;
-    p1Explosion.expandSpeed = EXPLOSION_EXPAND_SPEED;
-    p1Explosion.fadeSpeed = EXPLOSION_FADE_SPEED;
-    p1Explosion.damageDealt = false;
-    p1Explosion.shape.setOrigin(0,0); // será setado dinamicamente
-    p1Explosion.shape.setFillColor(sf::Color(255, 165, 0, 255)); // Laranja, opaco
-
-    // Seta a posição inicial e reseta as variáveis do jogo
-    resetGame(player1Alive, player2Alive, player1, player2, base, zombies, bullets, zombieSpawnClock, WORLD_W, WORLD_H);
-    
-    // LOOP PRINCIPAL
-    while (window.isOpen()) {
-        sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed)
-                window.close();
-            if (event.type == sf::Event::Resized) {
-                sf::FloatRect visibleArea(0, 0, (float)event.size.width, (float)event.size.height);
-                gameView.setSize(event.size.width, event.size.height);
+    FixedStep stepper;
+    stepper.init(tickRate, MAX_CATCHUP_TICKS);
+    float renderAlpha = 1.f; // Interpolação entre o tick anterior e o atual
+
+    ReplayRecorder recorder;
+    bool recording = false;
+
+    // Grava a partida em andamento (se houver) e para de gravar
+    auto finishRecording = [&]() {
+        if (!recording) return;
+        recording = false;
+        if (recorder.tickCount() == 0) return;
+        if (recorder.save(recordPath)) std::printf("replay: %zu ticks gravados em %s\n", recorder.tickCount(), recordPath);
+        else std::fprintf(stderr, "replay: nao foi possivel gravar %s\n", recordPath);
+    };
+
+    // Snapshots: anel para voltar no tempo (Backspace) e quicksave em disco (F5/F9)
+    const char* QUICKSAVE_PATH = "quicksave.snap";
+    const size_t REWIND_SNAPSHOTS = 12; // ~2 s por toque no Backspace
+    SnapshotRing rewindRing;
+    rewindRing.init(SNAPSHOT_RING_CAPACITY);
+    std::vector<unsigned char> quicksave;
+    long long gameTick = 0; // Ticks desde o começo da partida (ou do último rewind)
+
+    // Efeitos de tiros, mortes e explosões, gerados pelos eventos das fotos
+    ParticleSystem particles;
+    particles.init(PARTICLE_CAPACITY, nextSeed);
+
+    // Começa uma partida nova (e uma gravação nova, com --record)
+    auto beginGame = [&]() {
+        finishRecording();
+        std::uint64_t seed = nextSeed++;
+        startGame(sim, seed);
+        rewindRing.clear();
+        gameTick = 0;
+        if (recordPath) {
+            recorder.begin(seed, tickRate);
+            recording = true;
+        }
+    };
+
+    // Simulação e renderização em threads separadas, cada uma no seu ritmo: a
+    // simulação roda os ticks fixos e publica uma foto por iteração num buffer
+    // triplo; a renderização desenha a foto mais nova que houver, interpolando
+    // pelo tempo desde a publicação. Um present lento não atrasa ticks e um
+    // tick pesado não segura frames. No outro sentido vão só o teclado
+    // (amostrado a cada frame) e os comandos dos eventos, em atômicos.
+    TripleBuffer<RenderSnapshot> frames;
+    for (RenderSnapshot& f : frames.buffers) {
+        f.events.reserve(SIM_EVENT_CAPACITY);
+        f.effects.init(AREA_EFFECT_CAPACITY);
+    }
+    std::atomic<unsigned> pendingCommands{0};
+    std::atomic<std::uint32_t> commandEpoch{0};
+    std::atomic<std::uint32_t> liveInput{0}; // packPlayerInput do P1 (bits baixos) e do P2 (altos)
+    std::atomic<bool> simQuit{false};
+    std::uint32_t sentEpoch = 0; // Comandos enviados pela renderização
+
+    // A época é gravada depois dos bits: quem a lê já encontra o comando
+    auto sendCommand = [&](unsigned command) {
+        pendingCommands.fetch_or(command, std::memory_order_release);
+        commandEpoch.store(++sentEpoch, std::memory_order_release);
+    };
+
+    // Métricas de latência (cada lado mexe só nas suas até o join)
+    const size_t LATENCY_SAMPLES = 1 << 14;
+    LatencyStats tickStats, tickLateStats;          // Thread da simulação
+    LatencyStats snapshotAgeStats, frameTimeStats;  // Thread de renderização
+    tickStats.init(LATENCY_SAMPLES);
+    tickLateStats.init(LATENCY_SAMPLES);
+    snapshotAgeStats.init(LATENCY_SAMPLES);
+    frameTimeStats.init(LATENCY_SAMPLES);
+    long long skippedSnapshots = 0;   // Fotos publicadas que a renderização nunca leu
+    long long droppedEvents = 0;      // Eventos que não couberam na foto (renderização muito atrasada)
+    long long framesWithoutSnapshot = 0; // Frames que redesenharam a foto anterior
+
+    std::thread simThread([&]() {
+        bool running = netClient; // O cliente joga desde o começo, espelhando o servidor
+        bool p1AbilityPressed = false;
+        bool p2AbilityPressed = false;
+        std::uint32_t worldResets = 0;
+        std::uint64_t sequence = 0;
+        bool dirty = true; // Há algo novo para publicar
+        float lastTickMs = 0.f;
+        float lastLateMs = 0.f;
+        sf::Clock tickClock;
+
+        auto restartTicks = [&]() {
+            tickClock.restart();
+            stepper.reset();
+        };
+        // Mundo trocado: eventos pendentes são do mundo antigo
+        auto resetWorld = [&]() {
+            worldResets++;
+            frames.writeBuffer().events.clear();
+        };
+
+        while (!simQuit.load(std::memory_order_acquire)) {
+            // A época antes dos bits: se ela já conta um comando, ele está nos bits
+            std::uint32_t epoch = commandEpoch.load(std::memory_order_acquire);
+            unsigned commands = pendingCommands.exchange(0, std::memory_order_acq_rel);
+            if (commands != 0) dirty = true;
+
+            if (commands & CommandBeginGame) {
+                beginGame(); // Também reseta cooldowns das habilidades
+                resetWorld();
+                running = true;
+                restartTicks();
+            }
+            if (commands & CommandMenu) {
+                running = false;
+                finishRecording();
+                resetGame(sim);
+                resetWorld();
+            }
+            if (commands & CommandPause) running = false;
+            if (commands & CommandResume) {
+                running = true;
+                restartTicks(); // Reseta dt para evitar salto
             }
 
-            // Lógica de eventos para transição de estado e habilidades
-            if (event.type == sf::Event::KeyPressed) {
-                if (currentState == MainMenu && event.key.code == sf::Keyboard::Enter) {
-                    currentState = Playing;
-                    resetGame(player1Alive, player2Alive, player1, player2, base, zombies, bullets, zombieSpawnClock, WORLD_W, WORLD_H);
-                    startNextWave(); 
-                    // NOVO: Reseta cooldowns e flags de habilidade ao iniciar um jogo do menu
-                    p1AbilityCooldownClock.restart();
-                    p2AbilityCooldownClock.restart();
-                }
-                
-                if (currentState == GameOverScreen && event.key.code == sf::Keyboard::R) {
-                    currentState = Playing;
-                    resetGame(player1Alive, player2Alive, player1, player2, base, zombies, bullets, zombieSpawnClock, WORLD_W, WORLD_H);
-                    startNextWave(); 
-                    // NOVO: Reseta cooldowns e flags de habilidade ao reiniciar
-                    p1AbilityCooldownClock.restart();
-                    p2AbilityCooldownClock.restart();
+            // Quicksave (F5), quickload (F9) e rewind (Backspace). Voltar no
+            // tempo encerra a gravação do replay, que só anda para frente.
+            if (commands & CommandQuicksave) {
+                saveSnapshot(sim, quicksave);
+                if (saveSnapshotFile(QUICKSAVE_PATH, quicksave)) std::printf("snapshot: %zu bytes salvos em %s\n", quicksave.size(), QUICKSAVE_PATH);
+                else std::fprintf(stderr, "snapshot: nao foi possivel gravar %s\n", QUICKSAVE_PATH);
+            }
+            if (commands & CommandQuickload) {
+                if (loadSnapshotFile(QUICKSAVE_PATH, sim)) {
+                    finishRecording();
+                    rewindRing.clear();
+                    resetWorld();
+                    running = true;
+                    restartTicks();
+                } else {
+                    std::fprintf(stderr, "snapshot: nao foi possivel carregar %s\n", QUICKSAVE_PATH);
                 }
+            }
+            if ((commands & CommandRewind) && rewindRing.rewind(sim, REWIND_SNAPSHOTS, gameTick)) {
+                finishRecording();
+                resetWorld();
+                running = true;
+                restartTicks();
+            }
 
-                // Lógica de Pause/Unpause
-                if ((event.key.code == sf::Keyboard::Escape || event.key.code == sf::Keyboard::P) && currentState != GameOverScreen && currentState != MainMenu) {
-                    if (currentState == Playing) {
-                        currentState = Paused;
-                    } else if (currentState == Paused) {
-                        currentState = Playing;
-                        clock.restart(); // Reseta dt para evitar salto
-                    }
-                }
+            // Pulsos de habilidade valem para o próximo tick; parado, são descartados
+            if (commands & CommandP1Ability) p1AbilityPressed = true;
+            if (commands & CommandP2Ability) p2AbilityPressed = true;
+            if (!running) {
+                p1AbilityPressed = false;
+                p2AbilityPressed = false;
+            }
 
-                // Lógica dos Botões de Pause
-                if (currentState == Paused) {
-                    if (event.key.code == sf::Keyboard::R) {
-                        currentState = Playing;
-                        resetGame(player1Alive, player2Alive, player1, player2, base, zombies, bullets, zombieSpawnClock, WORLD_W, WORLD_H);
-                        startNextWave();
-                        // NOVO: Reseta cooldowns e flags de habilidade ao reiniciar do pause
-                        p1AbilityCooldownClock.restart();
-                        p2AbilityCooldownClock.restart();
-                        clock.restart();
-                    } else if (event.key.code == sf::Keyboard::M) {
-                        currentState = MainMenu;
-                        resetGame(player1Alive, player2Alive, player1, player2, base, zombies, bullets, zombieSpawnClock, WORLD_W, WORLD_H);
-                        // NOVO: Reseta cooldowns e flags de habilidade ao voltar para o menu
-                        p1AbilityCooldownClock.restart();
-                        p2AbilityCooldownClock.restart();
-                    } else if (event.key.code == sf::Keyboard::Q) { // 'Q' para Sair do Jogo
-                        window.close();
-                    }
+            // Cliente: aplica o estado mais novo do servidor (inclusive o game over dele)
+            if (netClient) {
+                client.poll(sim, stepper.tickDt);
+                dirty = true;
+            }
+            if (netServer) server.poll();
+
+            if (running) {
+                // Roda quantos ticks fixos couberem no tempo desde a última volta
+                int steps = stepper.advance(tickClock.restart().asSeconds());
+                if (steps > 0) {
+                    // O primeiro tick da volta era devido há (steps - 1) ticks mais a sobra
+                    lastLateMs = static_cast<float>(((steps - 1) * stepper.tickDt + stepper.accumulator) * 1000.0);
+                    tickLateStats.add(lastLateMs);
                 }
-
-                // Habilidade do Player 1 (Explosão) - Tecla E
-                if (currentState == Playing && player1Alive && event.key.code == sf::Keyboard::E) {
-                    if (p1AbilityCooldownClock.getElapsedTime().asSeconds() >= PLAYER1_ABILITY_COOLDOWN) {
-                        p1Explosion.active = true;
-                        p1Explosion.position = player1.getPosition();
-                        p1Explosion.currentRadius = 0.f;
-                        p1Explosion.damageDealt = false; // Reinicia para novo uso
-                        p1Explosion.shape.setFillColor(sf::Color(255, 165, 0, 255)); // Começa opaco
-                        p1AbilityCooldownClock.restart(); // Inicia o cooldown da habilidade
-
-                        // NOVO: Aplica dano imediatamente ao ativar a explosão
-                        // Isso garante que o dano é aplicado de forma consistente
-                        for (int i = zombies.size() - 1; i >= 0; --i) {
-                            if (checkCircleCollision(p1Explosion.position, p1Explosion.maxRadius, // Usa maxRadius para o dano
-                                                     zombies[i].sprite.getPosition(), zombies[i].radius)) {
-                                zombies.erase(zombies.begin() + i);
-                                zombiesRemaining--;
-                            }
-                        }
-                        p1Explosion.damageDealt = true; // Marca que o dano foi tratado
+                for (int s = 0; s < steps && !sim.gameOver; ++s) {
+                    auto tickStart = std::chrono::steady_clock::now();
+
+                    // Entradas do tick: teclado do último frame + pulsos de habilidade dos eventos
+                    std::uint32_t keys = liveInput.load(std::memory_order_relaxed);
+                    TickInput input;
+                    input.p1 = unpackPlayerInput(static_cast<std::uint16_t>(keys & 0xFFFFu));
+                    input.p2 = unpackPlayerInput(static_cast<std::uint16_t>(keys >> 16));
+                    input.p1.ability = p1AbilityPressed;
+                    input.p2.ability = p2AbilityPressed;
+                    p1AbilityPressed = false;
+                    p2AbilityPressed = false;
+                    dirty = true;
+
+                    if (netClient) {
+                        // O P2 anda na hora (previsão); o resto vem no próximo snapshot
+                        client.sendInput(sim, input.p2, stepper.tickDt);
+                        netTicks++;
+                        continue;
                     }
-                }
-
-                // Habilidade do Player 2 (Barricada) - Tecla NUM1
-                if (currentState == Playing && player2Alive && event.key.code == sf::Keyboard::Numpad1) {
-                    if (p2AbilityCooldownClock.getElapsedTime().asSeconds() >= PLAYER2_ABILITY_COOLDOWN) {
-                        Barricade newBarricade;
-                        newBarricade.shape.setSize(BARRICADE_SIZE);
-                        newBarricade.shape.setFillColor(sf::Color(0, 150, 255)); // Azul padrão
-                        newBarricade.shape.setOrigin(BARRICADE_SIZE.x / 2.f, BARRICADE_SIZE.y / 2.f); // Ajustado para centro do QUADRADO
-                        
-                        // Posição da barricada à frente do player 2
-                        // Usando o raio do player + metade da largura da barricada + um pequeno espaçamento
-                        float offset = player2.getRadius() + BARRICADE_SIZE.x / 2.f + 5.f; // Ajustado para quadrado
-                        sf::Vector2f barricadePos = player2.getPosition() + lastDir2 * offset;
-                        newBarricade.shape.setPosition(barricadePos);
-                        newBarricade.health = BARRIER_LIFE; // Atribui vida inicial
-                        newBarricade.maxHealth = BARRIER_LIFE; // Define vida máxima
-
-                        // Configura o texto de vida
-                        newBarricade.healthText.setFont(font);
-                        newBarricade.healthText.setCharacterSize(14);
-                        newBarricade.healthText.setFillColor(sf::Color::White);
-                        newBarricade.healthText.setOrigin(newBarricade.healthText.getLocalBounds().width / 2.f, newBarricade.healthText.getLocalBounds().height / 2.f);
-                        
-                        barricades.push_back(newBarricade);
-                        p2AbilityCooldownClock.restart(); // Inicia o cooldown da habilidade
+                    if (netServer) input.p2 = server.nextRemoteInput();
+
+                    if (gameTick % SNAPSHOT_INTERVAL_TICKS == 0) rewindRing.push(sim, gameTick);
+                    stepSimulation(sim, input, stepper.tickDt);
+                    // Com a renderização atrasada os eventos se acumulam na foto até
+                    // SIM_EVENT_CAPACITY (a capacidade reservada); o que passar é descartado
+                    std::vector<SimEvent>& pending = frames.writeBuffer().events;
+                    size_t room = SIM_EVENT_CAPACITY - std::min(SIM_EVENT_CAPACITY, pending.size());
+                    size_t taken = std::min(room, sim.events.size());
+                    pending.insert(pending.end(), sim.events.begin(), sim.events.begin() + taken);
+                    droppedEvents += static_cast<long long>(sim.events.size() - taken);
+                    gameTick++;
+                    if (recording) recorder.record(input, sim);
+                    if (netServer) {
+                        server.sendState(sim);
+                        netTicks++;
                     }
+                    lastTickMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - tickStart).count();
+                    tickStats.add(lastTickMs);
                 }
-            }
-        }
-
-        // NOVO: Somente atualiza a lógica do jogo se não estiver pausado
-        if (currentState == Playing) {
-            float dt = clock.restart().asSeconds();
-
-            // NOVO: Lógica da Habilidade do Player 1 (Explosão)
-            if (p1Explosion.active) {
-                // Expande o raio
-                p1Explosion.currentRadius += p1Explosion.expandSpeed * dt;
-                if (p1Explosion.currentRadius > p1Explosion.maxRadius) {
-                    p1Explosion.currentRadius = p1Explosion.maxRadius;
+                if (sim.gameOver && !netClient) {
+                    running = false;
+                    finishRecording();
                 }
+            }
 
-                // Desvanece a cor
-                sf::Color currentColor = p1Explosion.shape.getFillColor();
-                int alpha = currentColor.a - static_cast<int>(p1Explosion.fadeSpeed * dt);
-                if (alpha < 0) alpha = 0;
-                p1Explosion.shape.setFillColor(sf::Color(currentColor.r, currentColor.g, currentColor.b, alpha));
-
-                // Atualiza o shape da explosão
-                p1Explosion.shape.setRadius(p1Explosion.currentRadius);
-                p1Explosion.shape.setOrigin(p1Explosion.currentRadius, p1Explosion.currentRadius); // Centraliza a explosão
-                p1Explosion.shape.setPosition(p1Explosion.position);
-
-                // Desativa a explosão quando ela se torna totalmente transparente
-                if (alpha <= 0) {
-                    p1Explosion.active = false;
-                    p1Explosion.damageDealt = false; // Reset para próximo uso
-                }
+            if (dirty) {
+                RenderSnapshot& out = frames.writeBuffer();
+                captureRenderSnapshot(sim, out);
+                out.sequence = ++sequence;
+                out.epoch = epoch;
+                out.worldResets = worldResets;
+                out.tick = gameTick;
+                out.tickDt = stepper.tickDt;
+                out.alphaAtPublish = running ? stepper.alpha() : 1.f;
+                out.running = running;
+                out.tickMs = lastTickMs;
+                out.tickLateMs = lastLateMs;
+                out.publishedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+                // Se voltou uma foto não lida, os eventos dela seguem na próxima
+                if (frames.publish()) skippedSnapshots++;
+                else frames.writeBuffer().events.clear();
+                dirty = false;
             }
 
+            // Dorme até o próximo tick (parada, confere os comandos a cada tick)
+            double wait = running ? stepper.tickDt - stepper.accumulator : stepper.tickDt;
+            if (wait > 0.0) std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+        }
+    });
+
+    sf::Time startupTime = startupClock.getElapsedTime();
+    std::printf("inicializacao:    %.1f ms (janela %.1f ms, assets %.1f ms, %d glifos %.1f ms)\n",
+                startupTime.asSeconds() * 1000.0, windowTime.asSeconds() * 1000.0,
+                (assetsTime - windowTime).asSeconds() * 1000.0, warmedGlyphs,
+                (glyphsTime - assetsTime).asSeconds() * 1000.0);
+    bool firstFrame = true;     // Ainda não apresentou nenhum frame
+    bool firstGameFrame = true; // Ainda não apresentou um frame de jogo (HUD e lotes completos)
+    sf::Clock frameClock;
+    std::uint32_t seenWorldResets = 0;
+
+    // Estado inicial do Jogo (o cliente vai direto para o jogo espelhado do servidor)
+    GameState currentState = netClient ? Playing : MainMenu;
+    
+    // Telas paradas (menu, pause e game over) são desenhadas uma vez numa
+    // textura e só reapresentadas enquanto nada muda; a textura é refeita
+    // quando a tela troca, a janela muda de tamanho ou chega uma foto nova
+    sf::RenderTexture idleFrame;
+    bool idleFrameValid = false;
+    GameState idleFrameState = MainMenu;
+    // Menus em coordenadas da janela original (a view padrão da janela)
+    const sf::View screenView(sf::FloatRect(0, 0, (float)WINDOW_W, (float)WINDOW_H));
+    sf::RectangleShape darkOverlay(sf::Vector2f(WINDOW_W, WINDOW_H));
+    darkOverlay.setFillColor(sf::Color(0, 0, 0, 180));
+
+    // Ritmo dos frames durante o jogo: cheio com algo se mexendo na tela,
+    // reduzido com a cena parada ou a janela sem foco
+    bool windowFocused = true;
+    sf::Clock quietClock; // Tempo desde a última vez que algo se mexeu na tela
+    unsigned frameRateLimit = FRAME_RATE_ACTIVE;
+
+    // Eventos da janela: transições de estado e comandos para a simulação
+    auto handleEvent = [&](const sf::Event& event) {
+        if (event.type == sf::Event::Closed)
+            window.close();
+        if (event.type == sf::Event::Resized) {
+            gameView.setSize(event.size.width, event.size.height);
+            idleFrameValid = false; // A tela parada é refeita no tamanho novo
+        }
+        if (event.type == sf::Event::LostFocus) windowFocused = false;
+        if (event.type == sf::Event::GainedFocus) {
+            windowFocused = true;
+            idleFrameValid = false;
+        }
 
-            // LÓGICA DA CÂMERA (VIEW)
-            sf::Vector2f viewCenter;
-            if (player1Alive && player2Alive) {
-                viewCenter.x = (player1.getPosition().x + player2.getPosition().x) / 2.f;
-                viewCenter.y = (player1.getPosition().y + player2.getPosition().y) / 2.f;
-            } else if (player1Alive) {
-                viewCenter = player1.getPosition();
-            } else if (player2Alive) {
-                viewCenter = player2.getPosition();
-            } else {
-                viewCenter = base.getPosition(); 
-            }
+        // O cliente só controla o P2: menus, pause e snapshots ficam com o servidor
+        if (netClient && event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Numpad1) {
+            sendCommand(CommandP2Ability);
+        }
 
-            float halfViewW = gameView.getSize().x / 2.f;
-            float halfViewH = gameView.getSize().y / 2.f;
-            viewCenter.x = std::clamp(viewCenter.x, halfViewW, (float)WORLD_W - halfViewW);
-            viewCenter.y = std::clamp(viewCenter.y, halfViewH, (float)WORLD_H - halfViewH);
+        // Lógica de eventos para transição de estado e habilidades (o
+        // mundo muda na thread da simulação, pelos comandos)
+        if (!netClient && event.type == sf::Event::KeyPressed) {
+            if (currentState == MainMenu && event.key.code == sf::Keyboard::Enter) {
+                currentState = Playing;
+                sendCommand(CommandBeginGame);
+            }
             
-            gameView.setCenter(viewCenter);
-            // window.setView(gameView); // Será aplicado na renderização
-
+            if (currentState == GameOverScreen && event.key.code == sf::Keyboard::R) {
+                currentState = Playing;
+                sendCommand(CommandBeginGame);
+            }
 
-            // LÓGICA DO JOGO (MOVIMENTO, SPAWN, COLISÕES)
-            // Lógica de Spawn de Zumbis
-            if (zombiesSpawnedThisWave < zombiesToSpawn) { 
-                if (zombieSpawnClock.getElapsedTime().asSeconds() > ZOMBIE_SPAWN_TIME) {
-                    Zombie newZombie;
-                    newZombie.sprite.setTexture(zombieTexture);
-                    
-                    float targetSize = 24.f; 
-                    float originalSize = 64.f; 
-                    float scale = targetSize / originalSize; 
-                    
-                    newZombie.sprite.setScale(scale, scale);
-                    newZombie.sprite.setOrigin(originalSize / 2.f, originalSize / 2.f); 
-                    newZombie.radius = targetSize / 2.f; 
-                    
-                    int side = rand() % 4;
-                    float spawnX = 0, spawnY = 0;
-                    float spawnMargin = 60.f; 
-
-                    switch (side) {
-                        case 0: spawnX = static_cast<float>(rand() % WORLD_W); spawnY = -spawnMargin; break;
-                        case 1: spawnX = static_cast<float>(rand() % WORLD_W); spawnY = static_cast<float>(WORLD_H) + spawnMargin; break;
-                        case 2: spawnX = -spawnMargin; spawnY = static_cast<float>(rand() % WORLD_H); break;
-                        case 3: spawnX = static_cast<float>(WORLD_W) + spawnMargin; spawnY = static_cast<float>(rand() % WORLD_H); break;
-                    }
-                    newZombie.sprite.setPosition(spawnX, spawnY);
-                    zombies.push_back(newZombie);
-                    zombieSpawnClock.restart();
-                    zombiesSpawnedThisWave++; 
-                }
-            } else {
-                if (zombies.empty() && zombiesRemaining <= 0) {
-                        startNextWave();
+            // Lógica de Pause/Unpause
+            if ((event.key.code == sf::Keyboard::Escape || event.key.code == sf::Keyboard::P) && currentState != GameOverScreen && currentState != MainMenu) {
+                if (currentState == Playing) {
+                    currentState = Paused;
+                    sendCommand(CommandPause);
+                } else if (currentState == Paused) {
+                    currentState = Playing;
+                    sendCommand(CommandResume);
                 }
             }
 
-            // Player 1 movement (WASD)
-            if (player1Alive) {
-                sf::Vector2f dir1(0.f, 0.f);
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::W)) dir1.y -= 1.f;
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::S)) dir1.y += 1.f;
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::A)) dir1.x -= 1.f;
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::D)) dir1.x += 1.f;
-                
-                if (dir1.x != 0.f || dir1.y != 0.f) {
-                    float len = std::sqrt(dir1.x * dir1.x + dir1.y * dir1.y);
-                    dir1 /= len;
-                    lastDir1 = dir1;
-                }
-                
-                sf::Vector2f pos1 = player1.getPosition() + dir1 * SPEED * dt;
-                float r1 = player1.getRadius();
-                pos1.x = std::clamp(pos1.x, r1, (float)WORLD_W - r1); 
-                pos1.y = std::clamp(pos1.y, r1, (float)WORLD_H - r1); 
-                player1.setPosition(pos1);
-
-                // Player 1 shooting (F)
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::F)) {
-                    if (shootClock1.getElapsedTime().asMilliseconds() > BULLET_RATE) {
-                        Bullet b;
-                        b.shape.setRadius(BULLET_RADIUS); 
-                        b.shape.setFillColor(player1.getFillColor());
-                        b.shape.setOrigin(BULLET_RADIUS / 2.f, BULLET_RADIUS / 2.f); 
-                        b.shape.setPosition(player1.getPosition());
-                        b.velocity = lastDir1 * BULLET_SPEED; 
-                        bullets.push_back(b);
-                        shootClock1.restart();
-                    }
+            // Lógica dos Botões de Pause
+            if (currentState == Paused) {
+                if (event.key.code == sf::Keyboard::R) {
+                    currentState = Playing;
+                    sendCommand(CommandBeginGame);
+                } else if (event.key.code == sf::Keyboard::M) {
+                    currentState = MainMenu;
+                    sendCommand(CommandMenu);
+                } else if (event.key.code == sf::Keyboard::Q) { // 'Q' para Sair do Jogo
+                    window.close();
                 }
             }
 
-            // Player 2 movement (Arrow keys)
-            if (player2Alive) {
-                sf::Vector2f dir2(0.f, 0.f);
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up)) dir2.y -= 1.f;
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down)) dir2.y += 1.f;
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left)) dir2.x -= 1.f;
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right)) dir2.x += 1.f;
-                
-                if (dir2.x != 0.f || dir2.y != 0.f) {
-                    float len = std::sqrt(dir2.x * dir2.x + dir2.y * dir2.y);
-                    dir2 /= len;
-                    lastDir2 = dir2;
-                }
-                
-                sf::Vector2f pos2 = player2.getPosition() + dir2 * SPEED * dt;
-                float r2 = player2.getRadius();
-                pos2.x = std::clamp(pos2.x, r2, (float)WORLD_W - r2); 
-                pos2.y = std::clamp(pos2.y, r2, (float)WORLD_H - r2); 
-                player2.setPosition(pos2);
-
-                // Player 2 shooting (Numpad0)
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::Numpad0)) {
-                    if (shootClock2.getElapsedTime().asMilliseconds() > BULLET_RATE) {
-                        Bullet b;
-                        b.shape.setRadius(BULLET_RADIUS); 
-                        b.shape.setFillColor(player2.getFillColor());
-                        b.shape.setOrigin(BULLET_RADIUS / 2.f, BULLET_RADIUS / 2.f); 
-                        b.shape.setPosition(player2.getPosition());
-                        b.velocity = lastDir2 * BULLET_SPEED; 
-                        bullets.push_back(b);
-                        shootClock2.restart();
-                    }
-                }
+            // Habilidade do Player 1 (Explosão) - Tecla E
+            if (currentState == Playing && event.key.code == sf::Keyboard::E) {
+                sendCommand(CommandP1Ability);
             }
 
-            // Movimento dos Zumbis (IA marcha para a base ou barricada)
-            for (auto& z : zombies) {
-                sf::Vector2f zPos = z.sprite.getPosition(); 
-                sf::Vector2f currentTarget = base.getPosition(); // Target padrão é a base
-                sf::Vector2f zombieDir; 
-
-                // Verifica se há barricadas e se o zumbi deve ir para uma
-                Barricade* closestBarricade = nullptr;
-                float minDistanceToTarget = std::numeric_limits<float>::max(); // Distância para o alvo atual (base ou barricada)
-
-                // Primeiro, verifique se o zumbi já está colidindo com uma barricada
-                bool isCollidingWithBarricade = false;
-                for (auto& bar : barricades) {
-                    if (checkCircleRectCollision(zPos, z.radius, bar.shape.getPosition(), bar.shape.getSize())) {
-                        closestBarricade = &bar;
-                        isCollidingWithBarricade = true;
-                        currentTarget = bar.shape.getPosition(); // Define a barricada como alvo para cálculo de direção
-                        break; 
-                    }
-                }
+            // Habilidade do Player 2 (Barricada) - Tecla NUM1
+            if (currentState == Playing && event.key.code == sf::Keyboard::Numpad1) {
+                sendCommand(CommandP2Ability);
+            }
 
-                // Se não está colidindo, procure a barricada mais próxima no caminho para a base
-                if (!isCollidingWithBarricade) {
-                    for (auto& bar : barricades) {
-                        sf::Vector2f barCenter = bar.shape.getPosition();
-                        float distZtoBar = std::hypot(zPos.x - barCenter.x, zPos.y - barCenter.y);
-
-                        sf::Vector2f zToBase = base.getPosition() - zPos;
-                        sf::Vector2f zToBar = barCenter - zPos;
-                        
-                        float magnitudeZToBase = std::hypot(zToBase.x, zToBase.y);
-                        float magnitudeZToBar = std::hypot(zToBar.x, zToBar.y);
-
-                        if (magnitudeZToBase > 0 && magnitudeZToBar > 0) {
-                            float dotProduct = zToBase.x * zToBar.x + zToBase.y * zToBar.y;
-                            float angleCosine = dotProduct / (magnitudeZToBase * magnitudeZToBar);
-                            
-                            // Se a barricada estiver razoavelmente no caminho da base E estiver mais próxima que qualquer outra barricada
-                            if (angleCosine > 0.7f && distZtoBar < minDistanceToTarget) { // 0.7f para um cone de visão razoável
-                                minDistanceToTarget = distZtoBar;
-                                closestBarricade = &bar;
-                            }
-                        }
-                    }
-                }
+            // Quicksave (F5), quickload (F9) e rewind (Backspace); depois de
+            // um game over, a tela volta ao jogo quando a foto restaurada chega
+            if (currentState == Playing && event.key.code == sf::Keyboard::F5) {
+                sendCommand(CommandQuicksave);
+            }
+            bool canRestore = currentState == Playing || currentState == GameOverScreen;
+            if (canRestore && event.key.code == sf::Keyboard::F9) {
+                sendCommand(CommandQuickload);
+            }
+            if (canRestore && event.key.code == sf::Keyboard::Backspace) {
+                sendCommand(CommandRewind);
+            }
 
-                if (closestBarricade) {
-                    currentTarget = closestBarricade->shape.getPosition();
-                }
+            // Overlay do profiler
+            if (event.key.code == sf::Keyboard::F3) {
+                showProfiler = !showProfiler;
+                g_profiler.setEnabled(showProfiler || profileFromStart);
+                idleFrameValid = false;
+            }
+        }
+    };
 
+    // LOOP PRINCIPAL (thread de renderização: eventos, HUD e desenho)
+    while (window.isOpen()) {
+        // Tela parada já apresentada, sem comando a caminho da simulação:
+        // dorme até o próximo evento em vez de redesenhar a mesma imagem.
+        // O cliente não dorme, porque o servidor pode recomeçar a partida.
+        sf::Event event;
+        bool settled = frames.readBuffer().epoch == sentEpoch;
+        if (currentState != Playing && idleFrameValid && idleFrameState == currentState && settled && !netClient) {
+            if (window.waitEvent(event)) handleEvent(event);
+            clock.restart(); // O tempo dormindo não conta para as partículas
+        }
 
-                // Move o zumbi para o alvo (base ou barricada)
-                if (currentTarget != zPos) {
-                    zombieDir = currentTarget - zPos; 
-                    float len = std::hypot(zombieDir.x, zombieDir.y);
-                    if (len > 0) zombieDir /= len;
-                    z.sprite.move(zombieDir * ZOMBIE_SPEED * dt); 
-                }
+        frameClock.restart();
+        ProfileLap frameLap; // Frame inteiro
+        ProfileLap phaseLap; // Fases do loop principal (as do tick são medidas em stepSimulation)
+
+        while (window.pollEvent(event)) handleEvent(event);
+
+        // Teclado ao vivo para os ticks seguintes
+        PlayerInput p1Keys = readPlayerInput(sf::Keyboard::W, sf::Keyboard::S, sf::Keyboard::A, sf::Keyboard::D, sf::Keyboard::F);
+        PlayerInput p2Keys = readPlayerInput(sf::Keyboard::Up, sf::Keyboard::Down, sf::Keyboard::Left, sf::Keyboard::Right, sf::Keyboard::Numpad0);
+        liveInput.store(packPlayerInput(p1Keys) | (static_cast<std::uint32_t>(packPlayerInput(p2Keys)) << 16),
+                        std::memory_order_relaxed);
+        phaseLap.mark(PhaseEvents);
+
+        // Foto mais nova da simulação (ou a mesma do frame anterior)
+        bool freshSnapshot = frames.acquire();
+        const RenderSnapshot& snap = frames.readBuffer();
+        if (freshSnapshot) {
+            if (snap.worldResets != seenWorldResets) {
+                particles.clear();
+                seenWorldResets = snap.worldResets;
             }
+            particles.emitEvents(snap.events);
+        } else {
+            framesWithoutSnapshot++;
+        }
 
-            // Atualiza balas
-            for (auto& b : bullets)
-                b.shape.move(b.velocity * dt);
-
-            // Remove balas fora da tela
-            bullets.erase(std::remove_if(bullets.begin(), bullets.end(), [&](const Bullet& b) {
-                auto p = b.shape.getPosition();
-                return (p.y < -100 || p.y > WORLD_H + 100 || p.x < -100 || p.x > WORLD_W + 100); 
-            }), bullets.end());
-
-            // COLISÕES
-            // Colisão Balas vs Zumbis
-            for (int i = bullets.size() - 1; i >= 0; --i) {
-                for (int j = zombies.size() - 1; j >= 0; --j) {
-                    if (checkCircleCollision(bullets[i].shape.getPosition(), bullets[i].shape.getRadius(),
-                                             zombies[j].sprite.getPosition(), zombies[j].radius)) {
-                        bullets.erase(bullets.begin() + i);
-                        zombies.erase(zombies.begin() + j);
-                        zombiesRemaining--; 
-                        break; 
-                    }
-                }
-            }
+        // Segue a simulação (game over, restauração, estado do servidor) só
+        // quando ela já aplicou todos os comandos enviados
+        if (snap.epoch == sentEpoch) {
+            if (currentState == Playing && snap.gameOver) currentState = GameOverScreen;
+            else if (currentState == GameOverScreen && snap.running && !snap.gameOver) currentState = Playing;
+        }
 
-            // NOVO: Colisão Zumbis vs Barricadas (e empurrar para trás)
-            for (int i = zombies.size() - 1; i >= 0; --i) {
-                for (int j = barricades.size() - 1; j >= 0; --j) {
-                    // Se o zumbi está colidindo com a barricada
-                    if (checkCircleRectCollision(zombies[i].sprite.getPosition(), zombies[i].radius,
-                                                 barricades[j].shape.getPosition(), 
-                                                 barricades[j].shape.getSize())) {
-                        
-                        barricades[j].health--; // Barricada perde vida
-                        
-                        // Empurra o zumbi para trás (oposto à direção da barricada para o zumbi)
-                        sf::Vector2f zPos = zombies[i].sprite.getPosition();
-                        sf::Vector2f barPos = barricades[j].shape.getPosition();
-                        sf::Vector2f pushDir = zPos - barPos;
-                        float len = std::hypot(pushDir.x, pushDir.y);
-                        if (len > 0) pushDir /= len;
-                        
-                        zombies[i].sprite.move(pushDir * ZOMBIE_SPEED * dt * 2.0f); // Empurra com força
-                        
-                        // Remove a barricada se a vida acabar
-                        if (barricades[j].health <= 0) {
-                            barricades.erase(barricades.begin() + j);
-                        }
-                        break; // Zumbi só interage com uma barricada por vez
-                    }
-                }
-            }
+        // Interpolação pelo tempo desde a publicação (parada, mostra o tick atual)
+        std::int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        renderAlpha = 1.f;
+        if (snap.running && snap.tickDt > 0.f) {
+            renderAlpha = std::min(1.f, snap.alphaAtPublish + static_cast<float>((nowNs - snap.publishedNs) / 1e9) / snap.tickDt);
+        }
 
-            // Colisão Zumbis vs Base (GAME OVER)
-            float baseRadius = base.getSize().x / 2.f; 
-            for (auto& z : zombies) {
-                if (checkCircleCollision(z.sprite.getPosition(), z.radius, 
-                                         base.getPosition(), baseRadius)) {
-                    currentState = GameOverScreen; 
-                    zombiesRemaining--; 
-                    break; 
-                }
+        // Somente atualiza efeitos, câmera e HUD se não estiver pausado
+        if (currentState == Playing) {
+            float frameDt = clock.restart().asSeconds();
+            phaseLap.reset();
+            particles.update(frameDt);
+            phaseLap.mark(PhaseParticles);
+
+            // LÓGICA DA CÂMERA (VIEW), seguindo as posições interpoladas
+            const RenderPlayer& p1 = snap.players[0];
+            const RenderPlayer& p2 = snap.players[1];
+            sf::Vector2f p1Pos = interpolate(p1.prevPosition, p1.position, renderAlpha);
+            sf::Vector2f p2Pos = interpolate(p2.prevPosition, p2.position, renderAlpha);
+            sf::Vector2f viewCenter;
+            if (p1.alive && p2.alive) {
+                viewCenter.x = (p1Pos.x + p2Pos.x) / 2.f;
+                viewCenter.y = (p1Pos.y + p2Pos.y) / 2.f;
+            } else if (p1.alive) {
+                viewCenter = p1Pos;
+            } else if (p2.alive) {
+                viewCenter = p2Pos;
+            } else {
+                viewCenter = baseShape.getPosition(); 
             }
 
-            // Colisão Zumbi vs Players
-            if (currentState == Playing) { 
-                for (auto& z : zombies) {
-                    if (player1Alive && checkCircleCollision(z.sprite.getPosition(), z.radius, 
-                                                             player1.getPosition(), player1.getRadius())) {
-                        player1Alive = false;
-                    }
-                    if (player2Alive && checkCircleCollision(z.sprite.getPosition(), z.radius, 
-                                                             player2.getPosition(), player2.getRadius())) {
-                        player2Alive = false;
-                    }
-                }
-            }
+            float halfViewW = gameView.getSize().x / 2.f;
+            float halfViewH = gameView.getSize().y / 2.f;
+            viewCenter.x = std::clamp(viewCenter.x, halfViewW, (float)WORLD_W - halfViewW);
+            viewCenter.y = std::clamp(viewCenter.y, halfViewH, (float)WORLD_H - halfViewH);
+            
+            gameView.setCenter(viewCenter);
+            // window.setView(gameView); // Será aplicado na renderização
 
-            // ATUALIZA TEXTOS DO HUD
-            std::stringstream ssWave;
-            ssWave << "Wave: " << currentWave;
-            waveText.setString(ssWave.str());
-            waveText.setPosition(viewCenter.x, viewCenter.y - gameView.getSize().y / 2.f + 30.f); 
-            waveText.setOrigin(waveText.getLocalBounds().width / 2.f, waveText.getLocalBounds().height / 2.f);
+            // ATUALIZA TEXTOS DO HUD (só refaz a geometria do que mudou)
+            float viewW = gameView.getSize().x;
+            float viewH = gameView.getSize().y;
+            hud.setText(waveLabel, HudFormat().text("Wave: ").number(snap.wave));
+            hud.setPosition(waveLabel, sf::Vector2f(viewW / 2.f, 30.f));
 
-            std::stringstream ssZombies;
-            ssZombies << "Zumbis restantes: " << zombiesRemaining;
-            zombiesRemainingText.setString(ssZombies.str());
-            zombiesRemainingText.setPosition(viewCenter.x, viewCenter.y - gameView.getSize().y / 2.f + 60.f);
-            zombiesRemainingText.setOrigin(zombiesRemainingText.getLocalBounds().width / 2.f, zombiesRemainingText.getLocalBounds().height / 2.f);
+            hud.setText(zombiesLabel, HudFormat().text("Zumbis restantes: ").number(snap.zombiesRemaining));
+            hud.setPosition(zombiesLabel, sf::Vector2f(viewW / 2.f, 60.f));
 
             // NOVO: Atualiza textos de cooldown das habilidades
-            std::stringstream ssP1Ability;
-            float p1RemainingCooldown = PLAYER1_ABILITY_COOLDOWN - p1AbilityCooldownClock.getElapsedTime().asSeconds();
+            float p1RemainingCooldown = PLAYER1_ABILITY_COOLDOWN - p1.abilityTimer;
             if (p1RemainingCooldown <= 0) {
-                ssP1Ability << "P1 Habilidade: PRONTA (E)";
-                p1AbilityCooldownText.setFillColor(sf::Color::Green);
+                hud.setText(p1AbilityLabel, HudFormat().text("P1 Habilidade: PRONTA (E)"));
+                hud.setColor(p1AbilityLabel, sf::Color::Green);
             } else {
-                ssP1Ability << "P1 Habilidade: " << static_cast<int>(std::ceil(p1RemainingCooldown)) << "s (E)";
-                p1AbilityCooldownText.setFillColor(sf::Color::Red);
+                hud.setText(p1AbilityLabel, HudFormat().text("P1 Habilidade: ").number(static_cast<int>(std::ceil(p1RemainingCooldown))).text("s (E)"));
+                hud.setColor(p1AbilityLabel, sf::Color::Red);
             }
-            p1AbilityCooldownText.setString(ssP1Ability.str());
-            p1AbilityCooldownText.setOrigin(0, p1AbilityCooldownText.getLocalBounds().height / 2.f); // Canto inferior esquerdo, alinhado à esquerda
-            p1AbilityCooldownText.setPosition(viewCenter.x - gameView.getSize().x / 2.f + 10.f, viewCenter.y + gameView.getSize().y / 2.f - 40.f);
+            hud.setPosition(p1AbilityLabel, sf::Vector2f(10.f, viewH - 40.f));
 
-            std::stringstream ssP2Ability;
-            float p2RemainingCooldown = PLAYER2_ABILITY_COOLDOWN - p2AbilityCooldownClock.getElapsedTime().asSeconds();
+            float p2RemainingCooldown = PLAYER2_ABILITY_COOLDOWN - p2.abilityTimer;
             if (p2RemainingCooldown <= 0) {
-                ssP2Ability << "P2 Habilidade: PRONTA (L)";
-                p2AbilityCooldownText.setFillColor(sf::Color::Green);
+                hud.setText(p2AbilityLabel, HudFormat().text("P2 Habilidade: PRONTA (L)"));
+                hud.setColor(p2AbilityLabel, sf::Color::Green);
             } else {
-                ssP2Ability << "P2 Habilidade: " << static_cast<int>(std::ceil(p2RemainingCooldown)) << "s (NUM1)";
-                p2AbilityCooldownText.setFillColor(sf::Color::Blue);
+                hud.setText(p2AbilityLabel, HudFormat().text("P2 Habilidade: ").number(static_cast<int>(std::ceil(p2RemainingCooldown))).text("s (NUM1)"));
+                hud.setColor(p2AbilityLabel, sf::Color::Blue);
+            }
+            hud.setPosition(p2AbilityLabel, sf::Vector2f(viewW - 10.f, viewH - 40.f));
+
+            // NOVO: Texto de vida acima das barricadas (só as na tela ganham texto)
+            sf::FloatRect labelArea = viewBounds(gameView);
+            size_t visibleLabels = 0;
+            for (const RenderBarricade& bar : snap.barricades) {
+                if (barricadeVisible(labelArea, bar.position)) visibleLabels++;
             }
-            p2AbilityCooldownText.setString(ssP2Ability.str());
-            p2AbilityCooldownText.setOrigin(p2AbilityCooldownText.getLocalBounds().width, p2AbilityCooldownText.getLocalBounds().height / 2.f); // Canto inferior direito, alinhado à direita
-            p2AbilityCooldownText.setPosition(viewCenter.x + gameView.getSize().x / 2.f - 10.f, viewCenter.y + gameView.getSize().y / 2.f - 40.f);
-
-            // NOVO: Atualiza o texto e a cor da barricada
-            for (auto& bar : barricades) {
-                std::stringstream ssBarHealth;
-                ssBarHealth << bar.health << "/" << bar.maxHealth;
-                bar.healthText.setString(ssBarHealth.str());
-                // Posição do texto acima da barricada
-                bar.healthText.setPosition(bar.shape.getPosition().x, bar.shape.getPosition().y - BARRICADE_SIZE.y / 2.f - 10.f);
-                bar.healthText.setOrigin(bar.healthText.getLocalBounds().width / 2.f, bar.healthText.getLocalBounds().height / 2.f);
-
-                // Altera a cor da barricada de azul para vermelho conforme perde vida
-                float healthRatio = static_cast<float>(bar.health) / bar.maxHealth;
-                sf::Uint8 red = static_cast<sf::Uint8>(255 * (1.f - healthRatio)); // Aumenta o vermelho conforme a vida diminui
-                sf::Uint8 blue = static_cast<sf::Uint8>(255 * healthRatio);        // Diminui o azul conforme a vida diminui
-                bar.shape.setFillColor(sf::Color(red, 150, blue)); 
+            hud.setWorldLabelCount(visibleLabels, 14);
+            size_t label = 0;
+            for (const RenderBarricade& bar : snap.barricades) {
+                if (!barricadeVisible(labelArea, bar.position)) continue;
+                sf::Vector2f labelPos(bar.position.x, bar.position.y - BARRICADE_SIZE.y / 2.f - 10.f);
+                hud.setWorldLabel(label++, HudFormat().number(bar.health).text("/").number(bar.maxHealth), labelPos);
             }
+            hud.update(gameView);
+            phaseLap.mark(PhaseHud);
         } else { // Se o jogo estiver pausado, o delta time deve ser 0 para não atualizar nada
              clock.restart();
         }
         
         // RENDERIZAÇÃO (fora do if(Playing) para que o pause mostre o estado atual)
-        window.clear(sf::Color(20, 20, 20)); 
-
-        switch (currentState) {
-            case MainMenu:
-                window.setView(window.getDefaultView());
-                window.clear(sf::Color(10, 10, 30));
-                window.draw(titleText);
-                window.draw(playButtonText);
-                break;
-
-            case Playing:
-            case Paused: // Ambos os estados usam a mesma lógica de renderização do jogo principal
-                window.setView(gameView); // Aplica a view do jogo para ambos
-                window.draw(background); 
-                window.draw(base); 
-                if (player1Alive) window.draw(player1);
-                if (player2Alive) window.draw(player2);
-                for (auto& z : zombies) window.draw(z.sprite); 
-                for (auto& b : bullets) window.draw(b.shape);
-                for (auto& bar : barricades) { 
-                    window.draw(bar.shape);
-                    window.draw(bar.healthText);
-                }
-                if (p1Explosion.active) window.draw(p1Explosion.shape); 
+        cullStats = CullStats();
+        auto drawFrame = [&](sf::RenderTarget& target, DrawCounter& frame) {
+            target.clear(sf::Color(20, 20, 20));
+
+            // Só o que toca a view do jogo chega a ser desenhado
+            sf::FloatRect visibleArea = viewBounds(gameView);
+
+            switch (currentState) {
+                case MainMenu:
+                    target.setView(screenView);
+                    target.clear(sf::Color(10, 10, 30));
+                    frame.draw(titleText);
+                    frame.draw(playButtonText);
+                    break;
+
+                case Playing:
+                case Paused: // Ambos os estados usam a mesma lógica de renderização do jogo principal
+                    target.setView(gameView); // Aplica a view do jogo para ambos
+                    frame.draw(background); 
+                    if (cullStats.count(visibleArea.intersects(baseShape.getGlobalBounds()))) frame.draw(baseShape);
+                    // Players, zumbis e balas são desenhados entre o tick anterior e o atual
+                    for (int k = 0; k < 2; ++k) {
+                        const RenderPlayer& player = snap.players[k];
+                        if (!player.alive) continue;
+                        sf::Vector2f pos = interpolate(player.prevPosition, player.position, renderAlpha);
+                        if (!cullStats.count(circleVisible(visibleArea, pos.x, pos.y, playerShapes[k].getRadius()))) continue;
+                        playerShapes[k].setPosition(pos);
+                        frame.draw(playerShapes[k]);
+                    }
+                    // Zumbis e balas: uma chamada de desenho para cada grupo
+                    batch.buildZombies(snap.zombies, atlas.region(SpriteZombie), renderAlpha, visibleArea, cullStats, &renderJobs);
+                    batch.drawZombies(frame, atlas.texture);
+                    batch.buildBullets(snap.bullets, renderAlpha, playerShapes[0].getFillColor(), playerShapes[1].getFillColor(),
+                                       atlas.whiteTexel(), visibleArea, cullStats);
+                    batch.drawBullets(frame, atlas.texture);
+                    particles.build(visibleArea, atlas.whiteTexel(), &renderJobs);
+                    particles.draw(frame, atlas.texture);
+                    for (const RenderBarricade& bar : snap.barricades) {
+                        if (!cullStats.count(barricadeVisible(visibleArea, bar.position))) continue;
+                        // A cor vai de azul a vermelho conforme a barricada perde vida
+                        float healthRatio = static_cast<float>(bar.health) / bar.maxHealth;
+                        sf::Uint8 red = static_cast<sf::Uint8>(255 * (1.f - healthRatio));
+                        sf::Uint8 blue = static_cast<sf::Uint8>(255 * healthRatio);
+                        barricadeShape.setFillColor(sf::Color(red, 150, blue));
+                        barricadeShape.setPosition(bar.position);
+                        frame.draw(barricadeShape);
+                    }
+                    // Explosões e outros efeitos de área: uma chamada para todos
+                    batch.buildEffects(snap.effects, atlas.whiteTexel(), visibleArea, cullStats);
+                    batch.drawEffects(frame, atlas.texture);
                 
-                // Textos do HUD (wave, zumbis, cooldowns) devem ser desenhados na view do jogo
-                window.draw(waveText);
-                window.draw(zombiesRemainingText);
-                window.draw(p1AbilityCooldownText);
-                window.draw(p2AbilityCooldownText);
-
-                // Se estiver pausado, desenha o overlay e o menu de pause *por cima* da view do jogo
-                if (currentState == Paused) {
-                    window.setView(window.getDefaultView()); // Volta para a view padrão para o menu de pause
-                    sf::RectangleShape darkOverlay(sf::Vector2f(WINDOW_W, WINDOW_H));
-                    darkOverlay.setFillColor(sf::Color(0, 0, 0, 180));
-                    window.draw(darkOverlay);
-
-                    pausedText.setPosition(WINDOW_W / 2.f, WINDOW_H / 2.f - 100.f);
-                    window.draw(pausedText);
-                    continueText.setPosition(WINDOW_W / 2.f, WINDOW_H / 2.f + 0.f);
-                    window.draw(continueText);
-                    restartText.setPosition(WINDOW_W / 2.f, WINDOW_H / 2.f + 40.f);
-                    window.draw(restartText);
-                    exitToMenuText.setPosition(WINDOW_W / 2.f, WINDOW_H / 2.f + 80.f);
-                    window.draw(exitToMenuText);
-                    exitGameText.setPosition(WINDOW_W / 2.f, WINDOW_H / 2.f + 120.f);
-                    window.draw(exitGameText);
-                }
-                break;
+                    // HUD (wave, zumbis, cooldowns e vida das barricadas) em uma chamada, na view do jogo
+                    hud.draw(frame);
+                    if (showProfiler) {
+                        profilerOverlay.update(g_profiler, gameView);
+                        profilerOverlay.draw(frame);
+                    }
 
-            case GameOverScreen:
-                window.setView(window.getDefaultView());
-                window.clear(sf::Color(30, 0, 0));
-                window.draw(gameOverText);
-                break;
+                    // Se estiver pausado, desenha o overlay e o menu de pause *por cima* da view do jogo
+                    if (currentState == Paused) {
+                        target.setView(screenView); // Volta para a view da tela para o menu de pause
+                        frame.draw(darkOverlay);
+
+                        pausedText.setPosition(WINDOW_W / 2.f, WINDOW_H / 2.f - 100.f);
+                        frame.draw(pausedText);
+                        continueText.setPosition(WINDOW_W / 2.f, WINDOW_H / 2.f + 0.f);
+                        frame.draw(continueText);
+                        restartText.setPosition(WINDOW_W / 2.f, WINDOW_H / 2.f + 40.f);
+                        frame.draw(restartText);
+                        exitToMenuText.setPosition(WINDOW_W / 2.f, WINDOW_H / 2.f + 80.f);
+                        frame.draw(exitToMenuText);
+                        exitGameText.setPosition(WINDOW_W / 2.f, WINDOW_H / 2.f + 120.f);
+                        frame.draw(exitGameText);
+                    }
+                    break;
+
+                case GameOverScreen:
+                    target.setView(screenView);
+                    target.clear(sf::Color(30, 0, 0));
+                    frame.draw(gameOverText);
+                    break;
+            }
+        };
+
+        DrawCounter frame(window);
+        if (currentState == Playing) {
+            drawFrame(window, frame);
+        } else {
+            // Tela parada: refaz a textura só quando algo mudou, depois só a apresenta
+            if (freshSnapshot) idleFrameValid = false;
+            sf::Vector2u size = window.getSize();
+            if (!idleFrameValid || idleFrameState != currentState) {
+                if (idleFrame.getSize() != size) idleFrame.create(size.x, size.y);
+                DrawCounter cached(idleFrame);
+                drawFrame(idleFrame, cached);
+                idleFrame.display();
+                idleFrameValid = true;
+                idleFrameState = currentState;
+            }
+            window.setView(sf::View(sf::FloatRect(0, 0, (float)size.x, (float)size.y)));
+            frame.draw(sf::Sprite(idleFrame.getTexture()));
+        }
+
+        // Ritmo do próximo frame: com a cena parada (nada visível se mexendo
+        // e nenhuma tecla) por um tempo, ou a janela sem foco, não adianta
+        // desenhar mais rápido que a simulação muda a tela
+        if (currentState == Playing) {
+            bool playersMoving = snap.players[0].prevPosition != snap.players[0].position ||
+                                 snap.players[1].prevPosition != snap.players[1].position;
+            bool sceneMoving = playersMoving || particles.count > 0 || snap.bullets.count > 0 || !snap.effects.empty() ||
+                               batch.zombieVertices.getVertexCount() > 0 || liveInput.load(std::memory_order_relaxed) != 0;
+            if (sceneMoving) quietClock.restart();
+        }
+        bool quiet = currentState != Playing || quietClock.getElapsedTime().asSeconds() >= QUIET_DELAY;
+        unsigned targetRate = (quiet || !windowFocused) ? FRAME_RATE_QUIET : FRAME_RATE_ACTIVE;
+        if (targetRate != frameRateLimit) {
+            frameRateLimit = targetRate;
+            window.setFramerateLimit(frameRateLimit);
         }
         
         // Exibe o frame final para todos os estados
         window.display();
+        if (firstFrame) {
+            std::printf("primeiro frame:   %.1f ms depois do inicio (%.1f ms de frame)\n",
+                        startupClock.getElapsedTime().asSeconds() * 1000.0, frameClock.getElapsedTime().asSeconds() * 1000.0);
+            firstFrame = false;
+        }
+        if (firstGameFrame && currentState == Playing) {
+            std::printf("primeiro frame de jogo: %.1f ms\n", frameClock.getElapsedTime().asSeconds() * 1000.0);
+            firstGameFrame = false;
+        }
+
+        // Latência vista pela renderização: da publicação da foto até o present
+        float snapshotAgeMs = 0.f;
+        if (snap.sequence > 0) {
+            std::int64_t presentNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            snapshotAgeMs = static_cast<float>((presentNs - snap.publishedNs) / 1e6);
+            if (currentState == Playing) snapshotAgeStats.add(snapshotAgeMs);
+        }
+        frameTimeStats.add(frameClock.getElapsedTime().asSeconds() * 1000.f);
+        phaseLap.mark(PhaseRender);
+        frameLap.mark(PhaseFrame);
+        g_profiler.endFrame(static_cast<int>(snap.zombies.size()), snap.bullets.size(), static_cast<int>(snap.barricades.size()));
+
+        // Atualiza o contador de chamadas de desenho no título (no máximo 2x por segundo)
+        bool statsChanged = frame.calls != lastDrawCalls || cullStats.drawn != lastCullStats.drawn || cullStats.culled != lastCullStats.culled;
+        if (drawStatsClock.getElapsedTime().asSeconds() >= 0.5f && statsChanged) {
+            char latency[96];
+            std::snprintf(latency, sizeof(latency), " | tick: %.2f ms (atraso %.2f ms), foto na tela: %.1f ms",
+                          snap.tickMs, snap.tickLateMs, snapshotAgeMs);
+            window.setTitle("SFML Zomboid - chamadas de desenho/frame: " + std::to_string(frame.calls) +
+                            " | entidades desenhadas: " + std::to_string(cullStats.drawn) +
+                            ", fora da tela: " + std::to_string(cullStats.culled) +
+                            " | particulas: " + std::to_string(particles.count) + latency +
+                            " | limite: " + std::to_string(frameRateLimit) + " fps");
+            lastDrawCalls = frame.calls;
+            lastCullStats = cullStats;
+            drawStatsClock.restart();
+        }
+    }
+
+    simQuit.store(true, std::memory_order_release);
+    simThread.join();
+
+    // Partida interrompida ao fechar a janela também é gravada
+    finishRecording();
+
+    std::printf("latencia (simulacao e renderizacao em threads separadas):\n");
+    tickStats.print("tick:");
+    tickLateStats.print("atraso do tick:");
+    snapshotAgeStats.print("foto ate o present:");
+    frameTimeStats.print("frame:");
+    std::printf("  fotos puladas:          %lld (a renderizacao so pega a mais nova)\n", skippedSnapshots);
+    std::printf("  frames sem foto nova:   %lld\n", framesWithoutSnapshot);
+    std::printf("  eventos descartados:    %lld\n", droppedEvents);
+
+    if (netServer) server.stats.print("servidor", netTicks, tickRate);
+    if (netClient) client.stats.print("cliente", netTicks, tickRate);
+
+    // Grava as amostras do profiler, se houve coleta
+    if (g_profiler.writeCsv(profileCsvPath)) {
+        unsigned long long saved = std::min<unsigned long long>(g_profiler.frameCount(), PROFILER_RING_CAPACITY);
+        std::printf("profiler: %llu frames gravados em %s\n", saved, profileCsvPath);
     }
 
     return 0;
@@ -0,0 +1,824 @@
+#include "net.hpp"
+#include "headless.hpp"
+#include "replay.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+enum NetPacketType : std::uint8_t {
+    PacketInput = 1,
+    PacketState = 2
+};
+
+static long long nowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::uint16_t quantizePosition(float v) {
+    float q = std::round((v + NET_POS_OFFSET) * NET_POS_SCALE);
+    if (!(q > 0.f)) return 0;
+    if (q > 65535.f) return 65535;
+    return static_cast<std::uint16_t>(q);
+}
+
+float dequantizePosition(std::uint16_t q) {
+    return static_cast<float>(q) / NET_POS_SCALE - NET_POS_OFFSET;
+}
+
+// Valor em [-1, 1] (direções, cossenos) em 1/127
+static std::int8_t quantizeUnit(float v) {
+    return static_cast<std::int8_t>(std::lround(std::clamp(v, -1.f, 1.f) * 127.f));
+}
+
+static std::uint16_t clampU16(float v) {
+    if (!(v > 0.f)) return 0;
+    if (v > 65535.f) return 65535;
+    return static_cast<std::uint16_t>(v);
+}
+
+// Inteiros em little-endian, independente da máquina
+struct NetWriter {
+    std::vector<std::uint8_t>& out;
+
+    void u8(std::uint8_t v) { out.push_back(v); }
+    void u16(std::uint16_t v) {
+        out.push_back(static_cast<std::uint8_t>(v));
+        out.push_back(static_cast<std::uint8_t>(v >> 8));
+    }
+    void u32(std::uint32_t v) {
+        u16(static_cast<std::uint16_t>(v));
+        u16(static_cast<std::uint16_t>(v >> 16));
+    }
+    void i32(std::int32_t v) { u32(static_cast<std::uint32_t>(v)); }
+};
+
+struct NetReader {
+    const std::uint8_t* p;
+    const std::uint8_t* end;
+    bool ok = true;
+
+    bool has(size_t n) {
+        if (!ok || static_cast<size_t>(end - p) < n) ok = false;
+        return ok;
+    }
+    std::uint8_t u8() {
+        if (!has(1)) return 0;
+        return *p++;
+    }
+    std::uint16_t u16() {
+        if (!has(2)) return 0;
+        std::uint16_t v = static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+        p += 2;
+        return v;
+    }
+    std::uint32_t u32() {
+        std::uint32_t lo = u16();
+        std::uint32_t hi = u16();
+        return lo | (hi << 16);
+    }
+    std::int32_t i32() { return static_cast<std::int32_t>(u32()); }
+};
+
+void captureNetState(const Simulation& sim, std::uint32_t tick, std::uint32_t ackInput, NetState& out) {
+    out.tick = tick;
+    out.ackInput = ackInput;
+    out.wave = sim.currentWave;
+    out.zombiesRemaining = sim.zombiesRemaining;
+    out.gameOver = sim.gameOver ? 1 : 0;
+
+    const Player* players[2] = { &sim.player1, &sim.player2 };
+    for (int k = 0; k < 2; ++k) {
+        sf::Vector2f pos = players[k]->shape.getPosition();
+        out.players[k].x = quantizePosition(pos.x);
+        out.players[k].y = quantizePosition(pos.y);
+        out.players[k].alive = players[k]->alive ? 1 : 0;
+        out.players[k].abilityCentis = clampU16(players[k]->abilityTimer * 100.f);
+    }
+
+    out.effects.clear();
+    for (const AreaEffect& e : sim.effects.items) {
+        if (!e.detonated) continue; // Pavio aceso ainda não aparece
+        if (out.effects.size() == NET_MAX_EFFECTS) break;
+        NetEffect n;
+        n.x = quantizePosition(e.position.x);
+        n.y = quantizePosition(e.position.y);
+        n.radius = clampU16(e.currentRadius * NET_POS_SCALE);
+        n.alpha = static_cast<std::uint8_t>(std::clamp(e.alpha, 0.f, 255.f));
+        n.shape = static_cast<std::uint8_t>(e.shape);
+        n.dirX = quantizeUnit(e.direction.x);
+        n.dirY = quantizeUnit(e.direction.y);
+        n.coneCos = quantizeUnit(e.coneCos);
+        out.effects.push_back(n);
+    }
+
+    const ZombieStore& zs = sim.zombies;
+    out.zombieId.assign(zs.id.begin(), zs.id.end());
+    out.zombieX.resize(zs.size());
+    out.zombieY.resize(zs.size());
+    for (size_t i = 0; i < zs.size(); ++i) {
+        out.zombieX[i] = quantizePosition(zs.x[i]);
+        out.zombieY[i] = quantizePosition(zs.y[i]);
+    }
+
+    const BulletPool& bp = sim.bullets;
+    size_t slots = static_cast<size_t>(bp.capacity());
+    out.bulletOwner.resize(slots);
+    out.bulletX.resize(slots);
+    out.bulletY.resize(slots);
+    for (size_t s = 0; s < slots; ++s) {
+        const Bullet& b = bp.slots[s];
+        out.bulletOwner[s] = b.active ? b.owner : 0;
+        out.bulletX[s] = b.active ? quantizePosition(b.position.x) : 0;
+        out.bulletY[s] = b.active ? quantizePosition(b.position.y) : 0;
+    }
+
+    size_t bars = sim.barricades.size();
+    out.barricadeX.resize(bars);
+    out.barricadeY.resize(bars);
+    out.barricadeHealth.resize(bars);
+    out.barricadeMaxHealth.resize(bars);
+    for (size_t j = 0; j < bars; ++j) {
+        const Barricade& bar = sim.barricades[j];
+        out.barricadeX[j] = quantizePosition(bar.shape.getPosition().x);
+        out.barricadeY[j] = quantizePosition(bar.shape.getPosition().y);
+        out.barricadeHealth[j] = clampU16(static_cast<float>(bar.health));
+        out.barricadeMaxHealth[j] = clampU16(static_cast<float>(bar.maxHealth));
+    }
+}
+
+// Modos de uma posição no delta (2 bits cada, 4 por byte)
+enum PairMode : std::uint8_t {
+    PairSame = 0,  // Igual à base
+    PairSmall = 1, // Diferença de um byte por eixo
+    PairFull = 2   // Valor inteiro
+};
+
+// Codifica 'n' posições; base(k, bx, by) dá a posição de base do item k, se houver
+template <typename BaseOf>
+static void encodePairs(NetWriter& w, const std::uint16_t* x, const std::uint16_t* y, size_t n, BaseOf base) {
+    size_t modeStart = w.out.size();
+    w.out.resize(modeStart + (n + 3) / 4, 0);
+    for (size_t k = 0; k < n; ++k) {
+        std::uint16_t bx, by;
+        PairMode mode = PairFull;
+        int dx = 0, dy = 0;
+        if (base(k, bx, by)) {
+            dx = static_cast<int>(x[k]) - bx;
+            dy = static_cast<int>(y[k]) - by;
+            if (dx == 0 && dy == 0) mode = PairSame;
+            else if (dx >= -128 && dx <= 127 && dy >= -128 && dy <= 127) mode = PairSmall;
+        }
+        w.out[modeStart + k / 4] |= static_cast<std::uint8_t>(mode << ((k % 4) * 2));
+        if (mode == PairSmall) {
+            w.u8(static_cast<std::uint8_t>(static_cast<std::int8_t>(dx)));
+            w.u8(static_cast<std::uint8_t>(static_cast<std::int8_t>(dy)));
+        } else if (mode == PairFull) {
+            w.u16(x[k]);
+            w.u16(y[k]);
+        }
+    }
+}
+
+template <typename BaseOf>
+static void decodePairs(NetReader& r, std::uint16_t* x, std::uint16_t* y, size_t n, BaseOf base) {
+    size_t modeBytes = (n + 3) / 4;
+    if (!r.has(modeBytes)) return;
+    const std::uint8_t* modes = r.p;
+    r.p += modeBytes;
+    for (size_t k = 0; k < n && r.ok; ++k) {
+        PairMode mode = static_cast<PairMode>((modes[k / 4] >> ((k % 4) * 2)) & 3);
+        std::uint16_t bx = 0, by = 0;
+        if (mode != PairFull && !base(k, bx, by)) {
+            r.ok = false; // Delta sem base
+            return;
+        }
+        if (mode == PairSame) {
+            x[k] = bx;
+            y[k] = by;
+        } else if (mode == PairSmall) {
+            int dx = static_cast<std::int8_t>(r.u8());
+            int dy = static_cast<std::int8_t>(r.u8());
+            x[k] = static_cast<std::uint16_t>(bx + dx);
+            y[k] = static_cast<std::uint16_t>(by + dy);
+        } else if (mode == PairFull) {
+            x[k] = r.u16();
+            y[k] = r.u16();
+        } else {
+            r.ok = false;
+        }
+    }
+}
+
+// Slots de bala ativos (dono != 0), na ordem dos slots
+static void activeSlots(const NetState& s, std::vector<std::uint32_t>& out) {
+    out.clear();
+    for (size_t k = 0; k < s.bulletOwner.size(); ++k) {
+        if (s.bulletOwner[k]) out.push_back(static_cast<std::uint32_t>(k));
+    }
+}
+
+// Acha zumbis pelo id numa lista de ids (a de um estado anterior). Quase
+// sempre o zumbi continua no mesmo índice; os que o swap-and-pop moveu são
+// procurados nos pares (id, índice) ordenados.
+struct ZombieIdIndex {
+    const std::vector<std::uint32_t>* ids = nullptr;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> sorted;
+
+    void build(const std::vector<std::uint32_t>& source) {
+        ids = &source;
+        sorted.resize(source.size());
+        for (size_t k = 0; k < source.size(); ++k) sorted[k] = { source[k], static_cast<std::uint32_t>(k) };
+        std::sort(sorted.begin(), sorted.end());
+    }
+
+    // Índice do zumbi 'id' (que estava no índice 'hint' no estado novo); -1 se não há
+    long find(std::uint32_t id, size_t hint) const {
+        if (hint < ids->size() && (*ids)[hint] == id) return static_cast<long>(hint);
+        auto it = std::lower_bound(sorted.begin(), sorted.end(), std::make_pair(id, 0u));
+        return it != sorted.end() && it->first == id ? static_cast<long>(it->second) : -1;
+    }
+};
+
+void encodeNetState(const NetState& cur, const NetState* base, std::vector<std::uint8_t>& out) {
+    out.clear();
+    NetWriter w{out};
+    w.u8(PacketState);
+    w.u32(cur.tick);
+    w.u32(base ? base->tick : NET_NO_TICK);
+    w.u32(cur.ackInput);
+    w.i32(cur.wave);
+    w.i32(cur.zombiesRemaining);
+    w.u8(cur.gameOver);
+    for (const NetPlayer& p : cur.players) {
+        w.u16(p.x);
+        w.u16(p.y);
+        w.u8(p.alive);
+        w.u16(p.abilityCentis);
+    }
+    w.u8(static_cast<std::uint8_t>(cur.effects.size()));
+    for (const NetEffect& e : cur.effects) {
+        w.u16(e.x);
+        w.u16(e.y);
+        w.u16(e.radius);
+        w.u8(e.alpha);
+        w.u8(e.shape);
+        w.u8(static_cast<std::uint8_t>(e.dirX));
+        w.u8(static_cast<std::uint8_t>(e.dirY));
+        w.u8(static_cast<std::uint8_t>(e.coneCos));
+    }
+
+    // Zumbis: um bit por zumbi para "mesmo id da base neste índice" (senão
+    // vai o id), depois as posições em delta sobre o mesmo id na base
+    size_t zombies = cur.zombieX.size();
+    w.u32(static_cast<std::uint32_t>(zombies));
+    size_t idStart = out.size();
+    out.resize(idStart + (zombies + 7) / 8, 0);
+    for (size_t k = 0; k < zombies; ++k) {
+        bool same = base && k < base->zombieId.size() && base->zombieId[k] == cur.zombieId[k];
+        if (same) out[idStart + k / 8] |= static_cast<std::uint8_t>(1u << (k % 8));
+        else w.u32(cur.zombieId[k]);
+    }
+    static thread_local ZombieIdIndex baseIds;
+    if (base) baseIds.build(base->zombieId);
+    encodePairs(w, cur.zombieX.data(), cur.zombieY.data(), zombies, [&](size_t k, std::uint16_t& bx, std::uint16_t& by) {
+        long b = base ? baseIds.find(cur.zombieId[k], k) : -1;
+        if (b < 0) return false;
+        bx = base->zombieX[b];
+        by = base->zombieY[b];
+        return true;
+    });
+
+    // Balas: donos de todos os slots (2 bits cada), depois as posições dos ativos
+    size_t slots = cur.bulletOwner.size();
+    w.u16(static_cast<std::uint16_t>(slots));
+    size_t ownerStart = out.size();
+    out.resize(ownerStart + (slots + 3) / 4, 0);
+    for (size_t k = 0; k < slots; ++k) {
+        out[ownerStart + k / 4] |= static_cast<std::uint8_t>((cur.bulletOwner[k] & 3) << ((k % 4) * 2));
+    }
+    static thread_local std::vector<std::uint32_t> active;
+    static thread_local std::vector<std::uint16_t> activeX, activeY;
+    activeSlots(cur, active);
+    activeX.resize(active.size());
+    activeY.resize(active.size());
+    for (size_t k = 0; k < active.size(); ++k) {
+        activeX[k] = cur.bulletX[active[k]];
+        activeY[k] = cur.bulletY[active[k]];
+    }
+    encodePairs(w, activeX.data(), activeY.data(), active.size(), [&](size_t k, std::uint16_t& bx, std::uint16_t& by) {
+        std::uint32_t s = active[k];
+        if (!base || s >= base->bulletOwner.size() || !base->bulletOwner[s]) return false;
+        bx = base->bulletX[s];
+        by = base->bulletY[s];
+        return true;
+    });
+
+    // Barricadas: poucas, vão inteiras quando mudam
+    size_t bars = cur.barricadeX.size();
+    w.u16(static_cast<std::uint16_t>(bars));
+    for (size_t j = 0; j < bars; ++j) {
+        bool same = base && j < base->barricadeX.size() &&
+                    base->barricadeX[j] == cur.barricadeX[j] && base->barricadeY[j] == cur.barricadeY[j] &&
+                    base->barricadeHealth[j] == cur.barricadeHealth[j] &&
+                    base->barricadeMaxHealth[j] == cur.barricadeMaxHealth[j];
+        w.u8(same ? 0 : 1);
+        if (same) continue;
+        w.u16(cur.barricadeX[j]);
+        w.u16(cur.barricadeY[j]);
+        w.u16(cur.barricadeHealth[j]);
+        w.u16(cur.barricadeMaxHealth[j]);
+    }
+}
+
+bool peekSnapshotBase(const std::uint8_t* data, size_t size, std::uint32_t& baseTick) {
+    NetReader r{data, data + size};
+    if (r.u8() != PacketState) return false;
+    r.u32();
+    baseTick = r.u32();
+    return r.ok;
+}
+
+bool decodeNetState(const std::uint8_t* data, size_t size, const NetState* base, NetState& out) {
+    NetReader r{data, data + size};
+    if (r.u8() != PacketState) return false;
+    out.tick = r.u32();
+    std::uint32_t baseTick = r.u32();
+    if (baseTick != NET_NO_TICK && (!base || base->tick != baseTick)) return false;
+    if (baseTick == NET_NO_TICK) base = nullptr;
+    out.ackInput = r.u32();
+    out.wave = r.i32();
+    out.zombiesRemaining = r.i32();
+    out.gameOver = r.u8();
+    for (NetPlayer& p : out.players) {
+        p.x = r.u16();
+        p.y = r.u16();
+        p.alive = r.u8();
+        p.abilityCentis = r.u16();
+    }
+    std::uint8_t effects = r.u8();
+    if (effects > NET_MAX_EFFECTS) return false;
+    out.effects.resize(effects);
+    for (NetEffect& e : out.effects) {
+        e.x = r.u16();
+        e.y = r.u16();
+        e.radius = r.u16();
+        e.alpha = r.u8();
+        e.shape = r.u8();
+        e.dirX = static_cast<std::int8_t>(r.u8());
+        e.dirY = static_cast<std::int8_t>(r.u8());
+        e.coneCos = static_cast<std::int8_t>(r.u8());
+    }
+
+    std::uint32_t zombies = r.u32();
+    if (!r.ok || zombies > static_cast<size_t>(r.end - r.p) * 4) return false; // Pelo menos 2 bits por zumbi
+    size_t idBytes = (zombies + 7) / 8;
+    if (!r.has(idBytes)) return false;
+    const std::uint8_t* sameId = r.p;
+    r.p += idBytes;
+    out.zombieId.resize(zombies);
+    for (size_t k = 0; k < zombies && r.ok; ++k) {
+        if (!(sameId[k / 8] & (1u << (k % 8)))) {
+            out.zombieId[k] = r.u32();
+        } else if (base && k < base->zombieId.size()) {
+            out.zombieId[k] = base->zombieId[k];
+        } else {
+            return false; // Id da base sem base
+        }
+    }
+    out.zombieX.resize(zombies);
+    out.zombieY.resize(zombies);
+    static thread_local ZombieIdIndex baseIds;
+    if (base) baseIds.build(base->zombieId);
+    decodePairs(r, out.zombieX.data(), out.zombieY.data(), zombies, [&](size_t k, std::uint16_t& bx, std::uint16_t& by) {
+        long b = base ? baseIds.find(out.zombieId[k], k) : -1;
+        if (b < 0) return false;
+        bx = base->zombieX[b];
+        by = base->zombieY[b];
+        return true;
+    });
+
+    size_t slots = r.u16();
+    size_t ownerBytes = (slots + 3) / 4;
+    if (!r.has(ownerBytes)) return false;
+    out.bulletOwner.resize(slots);
+    out.bulletX.assign(slots, 0);
+    out.bulletY.assign(slots, 0);
+    for (size_t k = 0; k < slots; ++k) out.bulletOwner[k] = (r.p[k / 4] >> ((k % 4) * 2)) & 3;
+    r.p += ownerBytes;
+
+    static thread_local std::vector<std::uint32_t> active;
+    static thread_local std::vector<std::uint16_t> activeX, activeY;
+    activeSlots(out, active);
+    activeX.resize(active.size());
+    activeY.resize(active.size());
+    decodePairs(r, activeX.data(), activeY.data(), active.size(), [&](size_t k, std::uint16_t& bx, std::uint16_t& by) {
+        std::uint32_t s = active[k];
+        if (!base || s >= base->bulletOwner.size() || !base->bulletOwner[s]) return false;
+        bx = base->bulletX[s];
+        by = base->bulletY[s];
+        return true;
+    });
+    for (size_t k = 0; k < active.size(); ++k) {
+        out.bulletX[active[k]] = activeX[k];
+        out.bulletY[active[k]] = activeY[k];
+    }
+
+    size_t bars = r.u16();
+    if (!r.ok || bars > static_cast<size_t>(r.end - r.p)) return false;
+    out.barricadeX.resize(bars);
+    out.barricadeY.resize(bars);
+    out.barricadeHealth.resize(bars);
+    out.barricadeMaxHealth.resize(bars);
+    for (size_t j = 0; j < bars && r.ok; ++j) {
+        if (r.u8() == 0) {
+            if (!base || j >= base->barricadeX.size()) return false;
+            out.barricadeX[j] = base->barricadeX[j];
+            out.barricadeY[j] = base->barricadeY[j];
+            out.barricadeHealth[j] = base->barricadeHealth[j];
+            out.barricadeMaxHealth[j] = base->barricadeMaxHealth[j];
+            continue;
+        }
+        out.barricadeX[j] = r.u16();
+        out.barricadeY[j] = r.u16();
+        out.barricadeHealth[j] = r.u16();
+        out.barricadeMaxHealth[j] = r.u16();
+    }
+    return r.ok && r.p == r.end;
+}
+
+void applyNetState(const NetState& state, Simulation& sim) {
+    sim.currentWave = state.wave;
+    sim.zombiesRemaining = state.zombiesRemaining;
+    sim.gameOver = state.gameOver != 0;
+
+    Player* players[2] = { &sim.player1, &sim.player2 };
+    for (int k = 0; k < 2; ++k) {
+        players[k]->alive = state.players[k].alive != 0;
+        players[k]->abilityTimer = state.players[k].abilityCentis / 100.f;
+    }
+    sim.player1.prevPosition = sim.player1.shape.getPosition();
+    sim.player1.shape.setPosition(dequantizePosition(state.players[0].x), dequantizePosition(state.players[0].y));
+
+    sim.effects.clear();
+    for (const NetEffect& n : state.effects) {
+        AreaEffect e;
+        e.position = sf::Vector2f(dequantizePosition(n.x), dequantizePosition(n.y));
+        e.currentRadius = n.radius / NET_POS_SCALE;
+        e.radius = e.currentRadius;
+        e.alpha = n.alpha;
+        e.shape = n.shape == AreaCone ? AreaCone : AreaCircle;
+        e.direction = sf::Vector2f(n.dirX / 127.f, n.dirY / 127.f);
+        e.coneCos = n.coneCos / 127.f;
+        e.detonated = true;
+        sim.effects.spawn(e);
+    }
+
+    // Zumbis: a posição atual do mesmo id vira a base da interpolação (as
+    // anteriores são guardadas antes, porque o índice pode ter mudado de dono)
+    ZombieStore& zs = sim.zombies;
+    static thread_local ZombieIdIndex previousIds;
+    static thread_local std::vector<std::uint32_t> oldIds;
+    static thread_local std::vector<float> oldX, oldY;
+    oldIds.swap(zs.id);
+    oldX.assign(zs.x.begin(), zs.x.end());
+    oldY.assign(zs.y.begin(), zs.y.end());
+    previousIds.build(oldIds);
+    size_t n = state.zombieX.size();
+    zs.x.resize(n);
+    zs.y.resize(n);
+    zs.prevX.resize(n);
+    zs.prevY.resize(n);
+    zs.radius.assign(n, ZOMBIE_RADIUS);
+    zs.id.assign(state.zombieId.begin(), state.zombieId.end());
+    zs.alive.assign(n, 1);
+    zs.dead.clear();
+    for (size_t i = 0; i < n; ++i) {
+        float x = dequantizePosition(state.zombieX[i]);
+        float y = dequantizePosition(state.zombieY[i]);
+        long before = previousIds.find(zs.id[i], i);
+        zs.prevX[i] = before >= 0 ? oldX[before] : x;
+        zs.prevY[i] = before >= 0 ? oldY[before] : y;
+        zs.x[i] = x;
+        zs.y[i] = y;
+    }
+
+    BulletPool& bp = sim.bullets;
+    if (static_cast<size_t>(bp.capacity()) != state.bulletOwner.size()) bp.init(static_cast<int>(state.bulletOwner.size()));
+    bp.count = 0;
+    for (size_t s = 0; s < state.bulletOwner.size(); ++s) {
+        Bullet& b = bp.slots[s];
+        bool wasActive = b.active;
+        b.active = state.bulletOwner[s] != 0;
+        if (!b.active) continue;
+        sf::Vector2f pos(dequantizePosition(state.bulletX[s]), dequantizePosition(state.bulletY[s]));
+        b.prevPosition = wasActive ? b.position : pos;
+        b.position = pos;
+        b.owner = state.bulletOwner[s];
+        bp.count++;
+    }
+
+    if (sim.barricades.size() != state.barricadeX.size()) sim.barricadeVersion++;
+    sim.barricades.clear();
+    for (size_t j = 0; j < state.barricadeX.size(); ++j) {
+        sf::Vector2f pos(dequantizePosition(state.barricadeX[j]), dequantizePosition(state.barricadeY[j]));
+        Barricade bar = makeBarricade(pos, state.barricadeMaxHealth[j]);
+        bar.health = state.barricadeHealth[j];
+        sim.barricades.add(bar);
+    }
+}
+
+void NetStats::print(const char* who, long long ticks, int tickRate) const {
+    double seconds = ticks > 0 ? static_cast<double>(ticks) / tickRate : 0.0;
+    long long snapshots = fullSnapshots + deltaSnapshots;
+    std::printf("%s: %lld pacotes enviados (%lld bytes), %lld recebidos (%lld bytes)\n",
+                who, packetsSent, bytesSent, packetsReceived, bytesReceived);
+    if (snapshots > 0) {
+        std::printf("  snapshots:        %lld delta, %lld completos, %lld grandes demais\n",
+                    deltaSnapshots, fullSnapshots, oversizePackets);
+    }
+    if (ticks > 0) {
+        long long bytes = std::max(bytesSent, bytesReceived);
+        std::printf("  banda:            %.1f bytes/tick, %.1f kbit/s (maior pacote %zu bytes)\n",
+                    static_cast<double>(bytes) / ticks, bytes * 8.0 / seconds / 1000.0, maxPacket);
+    }
+    if (!latencyMs.empty()) {
+        std::vector<double> sorted = latencyMs;
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0.0;
+        for (double v : sorted) sum += v;
+        std::printf("  latencia:         media %.2f ms, p50 %.2f ms, p99 %.2f ms, max %.2f ms (%zu amostras)\n",
+                    sum / sorted.size(), sorted[sorted.size() / 2],
+                    sorted[static_cast<size_t>(0.99 * (sorted.size() - 1))], sorted.back(), sorted.size());
+        std::printf("  correcoes do P2:  %lld\n", corrections);
+    }
+}
+
+bool NetServer::start(unsigned short port) {
+    if (socket.bind(port) != sf::Socket::Done) return false;
+    socket.setBlocking(false);
+    packet.reserve(sf::UdpSocket::MaxDatagramSize);
+    return true;
+}
+
+void NetServer::poll() {
+    std::uint8_t data[512];
+    std::size_t received = 0;
+    sf::IpAddress sender;
+    unsigned short port = 0;
+    while (socket.receive(data, sizeof(data), received, sender, port) == sf::Socket::Done) {
+        stats.packetsReceived++;
+        stats.bytesReceived += static_cast<long long>(received);
+
+        NetReader r{data, data + received};
+        if (r.u8() != PacketInput) continue;
+        std::uint32_t seq = r.u32();
+        std::uint32_t ack = r.u32();
+        int count = r.u8();
+        if (!r.ok || seq == 0) continue;
+
+        // Cliente novo, ou reiniciado (a sequência dele volta a 1)
+        bool restarted = newestInput >= NET_INPUT_WINDOW && seq <= newestInput - NET_INPUT_WINDOW;
+        if (!hasClient || sender != clientAddress || port != clientPort || restarted) resetClient(sender, port);
+        if (ack != NET_NO_TICK && ack < nextTick && (clientAck == NET_NO_TICK || ack > clientAck)) clientAck = ack;
+
+        for (int k = 0; k < count && r.ok; ++k) {
+            std::uint16_t bits = r.u16();
+            std::uint32_t s = seq - static_cast<std::uint32_t>(k);
+            if (!r.ok || s == 0) break;
+            if (s <= appliedInput || inputSeq[s % NET_INPUT_WINDOW] == s) continue;
+            inputSeq[s % NET_INPUT_WINDOW] = s;
+            inputBits[s % NET_INPUT_WINDOW] = bits;
+        }
+        newestInput = std::max(newestInput, seq);
+    }
+}
+
+void NetServer::resetClient(const sf::IpAddress& address, unsigned short port) {
+    hasClient = true;
+    clientAddress = address;
+    clientPort = port;
+    std::fill(std::begin(inputSeq), std::end(inputSeq), 0u);
+    newestInput = 0;
+    appliedInput = 0;
+    lastBits = 0;
+    clientAck = NET_NO_TICK;
+}
+
+PlayerInput NetServer::nextRemoteInput() {
+    if (newestInput > appliedInput + NET_MAX_INPUT_QUEUE) appliedInput = newestInput - NET_MAX_INPUT_QUEUE;
+    std::uint32_t next = appliedInput + 1;
+    if (inputSeq[next % NET_INPUT_WINDOW] != next && newestInput > next) {
+        // A próxima se perdeu de vez: pula para a mais antiga que chegou
+        std::uint32_t first = newestInput - next >= NET_INPUT_WINDOW ? newestInput - NET_INPUT_WINDOW + 1 : next + 1;
+        for (std::uint32_t s = first; s <= newestInput; ++s) {
+            if (inputSeq[s % NET_INPUT_WINDOW] == s) {
+                next = s;
+                break;
+            }
+        }
+    }
+    if (inputSeq[next % NET_INPUT_WINDOW] == next) {
+        appliedInput = next;
+        lastBits = inputBits[next % NET_INPUT_WINDOW];
+        return unpackPlayerInput(lastBits);
+    }
+    PlayerInput repeat = unpackPlayerInput(lastBits);
+    repeat.ability = false;
+    return repeat;
+}
+
+void NetServer::sendState(const Simulation& sim) {
+    if (!hasClient) return;
+    std::uint32_t tick = nextTick++;
+    NetState& cur = history[tick % NET_HISTORY];
+    captureNetState(sim, tick, appliedInput, cur);
+
+    const NetState* base = nullptr;
+    if (clientAck != NET_NO_TICK && tick - clientAck < NET_HISTORY && history[clientAck % NET_HISTORY].tick == clientAck) {
+        base = &history[clientAck % NET_HISTORY];
+    }
+    encodeNetState(cur, base, packet);
+    if (packet.size() > sf::UdpSocket::MaxDatagramSize) {
+        stats.oversizePackets++;
+        return;
+    }
+    if (socket.send(packet.data(), packet.size(), clientAddress, clientPort) != sf::Socket::Done) return;
+    stats.packetsSent++;
+    stats.bytesSent += static_cast<long long>(packet.size());
+    stats.maxPacket = std::max(stats.maxPacket, packet.size());
+    if (base) stats.deltaSnapshots++;
+    else stats.fullSnapshots++;
+}
+
+bool NetClient::start(const sf::IpAddress& address, unsigned short port) {
+    serverAddress = address;
+    serverPort = port;
+    if (socket.bind(sf::Socket::AnyPort) != sf::Socket::Done) return false;
+    socket.setBlocking(false);
+    buffer.resize(sf::UdpSocket::MaxDatagramSize);
+    stats.latencyMs.reserve(1 << 16);
+    return true;
+}
+
+void NetClient::sendInput(Simulation& sim, const PlayerInput& p2, float dt) {
+    std::uint32_t seq = ++inputSeq;
+    size_t slot = seq % NET_INPUT_WINDOW;
+    sentInput[slot] = p2;
+    sentBits[slot] = packPlayerInput(p2);
+    sentMicros[slot] = nowMicros();
+
+    std::uint8_t data[16 + 2 * NET_INPUT_REDUNDANCY];
+    int count = static_cast<int>(std::min<std::uint32_t>(seq, NET_INPUT_REDUNDANCY));
+    size_t n = 0;
+    data[n++] = PacketInput;
+    for (int b = 0; b < 4; ++b) data[n++] = static_cast<std::uint8_t>(seq >> (8 * b));
+    for (int b = 0; b < 4; ++b) data[n++] = static_cast<std::uint8_t>(newestTick >> (8 * b));
+    data[n++] = static_cast<std::uint8_t>(count);
+    for (int k = 0; k < count; ++k) {
+        std::uint16_t bits = sentBits[(seq - k) % NET_INPUT_WINDOW];
+        data[n++] = static_cast<std::uint8_t>(bits);
+        data[n++] = static_cast<std::uint8_t>(bits >> 8);
+    }
+    if (socket.send(data, n, serverAddress, serverPort) == sf::Socket::Done) {
+        stats.packetsSent++;
+        stats.bytesSent += static_cast<long long>(n);
+    }
+
+    // Previsão: o P2 anda na hora, sem esperar o servidor
+    Player& p = sim.player2;
+    p.prevPosition = p.shape.getPosition();
+    if (p.alive) movePlayer(p, p2, dt);
+}
+
+bool NetClient::poll(Simulation& sim, float dt) {
+    bool updated = false;
+    std::size_t received = 0;
+    sf::IpAddress sender;
+    unsigned short port = 0;
+    static thread_local NetState incoming;
+    while (socket.receive(buffer.data(), buffer.size(), received, sender, port) == sf::Socket::Done) {
+        stats.packetsReceived++;
+        stats.bytesReceived += static_cast<long long>(received);
+        stats.maxPacket = std::max(stats.maxPacket, received);
+
+        std::uint32_t baseTick;
+        if (!peekSnapshotBase(buffer.data(), received, baseTick)) continue;
+        const NetState* base = nullptr;
+        if (baseTick != NET_NO_TICK) {
+            base = &history[baseTick % NET_HISTORY];
+            if (base->tick != baseTick) continue; // Base já descartada
+        }
+        if (!decodeNetState(buffer.data(), received, base, incoming)) continue;
+        if (newestTick != NET_NO_TICK && incoming.tick <= newestTick) continue; // Atrasado ou repetido
+
+        if (base) stats.deltaSnapshots++;
+        else stats.fullSnapshots++;
+        newestTick = incoming.tick;
+        std::swap(history[newestTick % NET_HISTORY], incoming);
+        updated = true;
+    }
+    if (!updated) return false;
+
+    const NetState& state = history[newestTick % NET_HISTORY];
+    Player& p2 = sim.player2;
+    sf::Vector2f predicted = p2.shape.getPosition();
+    sf::Vector2f prevPredicted = p2.prevPosition;
+    applyNetState(state, sim);
+
+    // Reconciliação: posição autoritativa + entradas que o servidor ainda não aplicou
+    p2.shape.setPosition(dequantizePosition(state.players[1].x), dequantizePosition(state.players[1].y));
+    if (p2.alive && state.ackInput <= inputSeq) {
+        std::uint32_t first = inputSeq - state.ackInput >= NET_INPUT_WINDOW ? inputSeq - NET_INPUT_WINDOW + 1 : state.ackInput + 1;
+        for (std::uint32_t s = first; s <= inputSeq; ++s) movePlayer(p2, sentInput[s % NET_INPUT_WINDOW], dt);
+    }
+    sf::Vector2f diff = p2.shape.getPosition() - predicted;
+    if (std::hypot(diff.x, diff.y) > 1.f) stats.corrections++;
+    p2.prevPosition = prevPredicted;
+
+    // Latência ponta a ponta da entrada que o servidor acabou de confirmar
+    if (state.ackInput > lastMeasured && state.ackInput <= inputSeq && inputSeq - state.ackInput < NET_INPUT_WINDOW) {
+        stats.latencyMs.push_back((nowMicros() - sentMicros[state.ackInput % NET_INPUT_WINDOW]) / 1000.0);
+        lastMeasured = state.ackInput;
+    }
+    return true;
+}
+
+// Espera até o próximo tick em tempo real
+static void waitNextTick(std::chrono::steady_clock::time_point& next) {
+    next += std::chrono::microseconds(1000000 / DEFAULT_TICK_RATE);
+    std::this_thread::sleep_until(next);
+}
+
+int runNetServerHeadless(unsigned short port, long long ticks, int initialZombies) {
+    NetServer server;
+    if (!server.start(port)) {
+        std::fprintf(stderr, "servidor: nao foi possivel abrir a porta %u\n", port);
+        return 1;
+    }
+
+    JobSystem jobs;
+    jobs.init(0);
+    SimConfig config;
+    if (initialZombies > 0) config.initialZombies = initialZombies;
+    Simulation sim;
+    initSimulation(sim, config);
+    sim.jobs = &jobs;
+    startGame(sim, HEADLESS_SEED);
+
+    std::printf("servidor: esperando o cliente na porta %u\n", port);
+    std::fflush(stdout);
+    while (!server.hasClient) {
+        server.poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    int games = 1;
+    size_t maxZombies = 0;
+    auto next = std::chrono::steady_clock::now();
+    for (long long t = 0; t < ticks; ++t) {
+        server.poll();
+        TickInput in = scriptedInput(sim, t);
+        in.p2 = server.nextRemoteInput();
+        stepSimulation(sim, in, HEADLESS_DT);
+        maxZombies = std::max(maxZombies, sim.zombies.size());
+        if (sim.gameOver) startGame(sim, HEADLESS_SEED + games++);
+        server.sendState(sim);
+        waitNextTick(next);
+    }
+
+    std::printf("servidor: %lld ticks, %d partidas, max %zu zumbis\n", ticks, games, maxZombies);
+    server.stats.print("servidor", ticks, DEFAULT_TICK_RATE);
+    return 0;
+}
+
+int runNetClientHeadless(const sf::IpAddress& address, unsigned short port, long long ticks) {
+    NetClient client;
+    if (!client.start(address, port)) {
+        std::fprintf(stderr, "cliente: nao foi possivel abrir o socket\n");
+        return 1;
+    }
+
+    Simulation sim;
+    initSimulation(sim);
+
+    auto next = std::chrono::steady_clock::now();
+    for (long long t = 0; t < ticks; ++t) {
+        PlayerInput p2 = client.connected() ? scriptedInput(sim, t).p2 : PlayerInput();
+        client.sendInput(sim, p2, HEADLESS_DT);
+        client.poll(sim, HEADLESS_DT);
+        waitNextTick(next);
+    }
+
+    if (!client.connected()) {
+        std::fprintf(stderr, "cliente: nenhum snapshot recebido\n");
+        return 1;
+    }
+    std::printf("cliente: %lld ticks, ultimo snapshot %u, %zu zumbis no espelho\n",
+                ticks, client.newestTick, sim.zombies.size());
+    client.stats.print("cliente", ticks, DEFAULT_TICK_RATE);
+    return 0;
+}
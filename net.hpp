@@ -0,0 +1,196 @@
+#pragma once
+
+#include <SFML/Network.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "simulation.hpp"
+
+// Co-op em dois processos por UDP. O servidor roda a simulação autoritativa
+// (P1 no teclado dele, P2 vindo da rede); o cliente manda as entradas do P2 a
+// cada tick e desenha o estado replicado, prevendo o próprio player.
+//
+// Servidor -> cliente: um snapshot por tick com posições quantizadas (1/8 px
+// em u16) de players, zumbis, balas e barricadas, codificado como delta sobre
+// o último snapshot que o cliente confirmou: cada posição vai como "igual",
+// diferença de um byte ou valor inteiro. Zumbis são casados com a base pelo
+// id (o servidor remove mortos com swap-and-pop, então o índice muda de
+// dono). Sem confirmação (começo, perda longa) vai o estado completo.
+// Cliente -> servidor: a entrada do tick com as 3 anteriores (redundância
+// contra perda), o número de sequência e a confirmação do último snapshot.
+// O servidor aplica uma entrada por tick, em ordem, e devolve no snapshot a
+// última aplicada: o cliente reaplica as posteriores sobre a posição
+// autoritativa do P2 (reconciliação) e mede a latência ponta a ponta (da
+// entrada enviada até o estado que já a contém).
+//
+// Uso: ./jogo --server [porta]              (P1 no teclado, espera o P2)
+//      ./jogo --client [ip] [porta]         (P2 nas setas / Numpad0 / Numpad1)
+//      ./jogo --server-headless [porta] [ticks] [zumbis iniciais]
+//      ./jogo --client-headless [ip] [porta] [ticks]
+// Os modos headless usam o bot de headless.hpp, rodam em tempo real e
+// imprimem banda e latência no fim.
+
+const unsigned short NET_DEFAULT_PORT = 47800;
+const size_t NET_HISTORY = 64;          // Snapshots guardados dos dois lados (base dos deltas)
+const size_t NET_INPUT_WINDOW = 128;    // Entradas guardadas para reconciliação e ordenação
+const int NET_INPUT_REDUNDANCY = 4;     // Entradas por pacote (a atual e as anteriores)
+const std::uint32_t NET_MAX_INPUT_QUEUE = 8; // Entradas do P2 esperando no servidor; as mais velhas são descartadas
+const std::uint32_t NET_NO_TICK = 0xFFFFFFFFu;
+
+// Posições em 1/8 px com deslocamento, cobrindo o mundo e a margem de spawn
+const float NET_POS_SCALE = 8.f;
+const float NET_POS_OFFSET = 256.f;
+const size_t NET_MAX_EFFECTS = 64; // Efeitos de área visíveis enviados por snapshot
+
+std::uint16_t quantizePosition(float v);
+float dequantizePosition(std::uint16_t q);
+
+struct NetPlayer {
+    std::uint16_t x = 0;
+    std::uint16_t y = 0;
+    std::uint8_t alive = 0;
+    std::uint16_t abilityCentis = 0; // abilityTimer em centésimos de segundo (para o HUD)
+};
+
+// Efeito de área já detonado (só o desenho: o dano acontece no servidor)
+struct NetEffect {
+    std::uint16_t x = 0;
+    std::uint16_t y = 0;
+    std::uint16_t radius = 0; // currentRadius em 1/NET_POS_SCALE px
+    std::uint8_t alpha = 0;
+    std::uint8_t shape = 0;
+    std::int8_t dirX = 0;    // Eixo do cone em 1/127
+    std::int8_t dirY = 0;
+    std::int8_t coneCos = 0; // Meia abertura do cone em 1/127
+};
+
+// Estado replicado, já quantizado (o cliente reconstrói exatamente os mesmos
+// valores que o servidor guardou, então os dois podem usá-lo como base)
+struct NetState {
+    std::uint32_t tick = NET_NO_TICK;
+    std::uint32_t ackInput = 0; // Última entrada do P2 aplicada pelo servidor
+    std::int32_t wave = 0;
+    std::int32_t zombiesRemaining = 0;
+    std::uint8_t gameOver = 0;
+    NetPlayer players[2];
+
+    std::vector<NetEffect> effects; // Poucos e curtos: vão inteiros em todo snapshot
+
+    std::vector<std::uint32_t> zombieId; // ZombieStore::id: a base dos deltas e da interpolação é o mesmo zumbi
+    std::vector<std::uint16_t> zombieX;
+    std::vector<std::uint16_t> zombieY;
+
+    // Por slot do pool de balas; dono 0 = slot livre
+    std::vector<std::uint8_t> bulletOwner;
+    std::vector<std::uint16_t> bulletX;
+    std::vector<std::uint16_t> bulletY;
+
+    std::vector<std::uint16_t> barricadeX;
+    std::vector<std::uint16_t> barricadeY;
+    std::vector<std::uint16_t> barricadeHealth;
+    std::vector<std::uint16_t> barricadeMaxHealth;
+};
+
+// Quantiza o estado da simulação
+void captureNetState(const Simulation& sim, std::uint32_t tick, std::uint32_t ackInput, NetState& out);
+
+// Pacote de snapshot de 'cur' em delta sobre 'base' (nullptr = completo)
+void encodeNetState(const NetState& cur, const NetState* base, std::vector<std::uint8_t>& out);
+
+// Tick da base de um pacote de snapshot (NET_NO_TICK = completo); false se não é snapshot
+bool peekSnapshotBase(const std::uint8_t* data, size_t size, std::uint32_t& baseTick);
+
+// Decodifica um pacote de snapshot sobre 'base' (que deve ser o estado do tick indicado no pacote)
+bool decodeNetState(const std::uint8_t* data, size_t size, const NetState* base, NetState& out);
+
+// Copia o estado replicado para a simulação espelho do cliente (o P2 fica
+// por conta da previsão). A posição atual vira a anterior, para interpolar;
+// zumbis com id novo começam parados na posição recebida.
+void applyNetState(const NetState& state, Simulation& sim);
+
+// Contadores de tráfego e latência
+struct NetStats {
+    long long packetsSent = 0;
+    long long packetsReceived = 0;
+    long long bytesSent = 0;
+    long long bytesReceived = 0;
+    long long fullSnapshots = 0;
+    long long deltaSnapshots = 0;
+    long long oversizePackets = 0; // Snapshots maiores que um datagrama (não enviados)
+    size_t maxPacket = 0;
+    long long corrections = 0;     // Reconciliações que moveram o P2 mais de 1 px
+    std::vector<double> latencyMs; // Entrada enviada -> snapshot que a contém
+
+    // Imprime o resumo; 'ticks' é a duração medida
+    void print(const char* who, long long ticks, int tickRate) const;
+};
+
+struct NetServer {
+    sf::UdpSocket socket;
+    bool hasClient = false;
+    sf::IpAddress clientAddress;
+    unsigned short clientPort = 0;
+
+    // Entradas do P2 por sequência
+    std::uint32_t inputSeq[NET_INPUT_WINDOW] = {};
+    std::uint16_t inputBits[NET_INPUT_WINDOW] = {};
+    std::uint32_t newestInput = 0;
+    std::uint32_t appliedInput = 0;
+    std::uint16_t lastBits = 0;
+
+    std::uint32_t clientAck = NET_NO_TICK; // Snapshot mais novo que o cliente confirmou
+    std::uint32_t nextTick = 0;
+    NetState history[NET_HISTORY];
+    std::vector<std::uint8_t> packet;
+    NetStats stats;
+
+    bool start(unsigned short port);
+
+    // Lê os pacotes de entrada que chegaram (não bloqueia)
+    void poll();
+
+    // Começa uma sessão nova com o cliente em 'address':'port' (outro
+    // endereço, ou o mesmo recomeçando a sequência de entradas): esquece as
+    // entradas e a confirmação do anterior, então o próximo snapshot é completo
+    void resetClient(const sf::IpAddress& address, unsigned short port);
+
+    // Entrada do P2 para este tick: a próxima em ordem; se ela não chegou,
+    // repete o movimento da última (sem pulsos de habilidade). Uma fila maior
+    // que NET_MAX_INPUT_QUEUE (servidor pausado, rajada atrasada) é cortada
+    // para o P2 não ficar jogando no passado.
+    PlayerInput nextRemoteInput();
+
+    // Envia o snapshot do estado atual (depois do tick)
+    void sendState(const Simulation& sim);
+};
+
+struct NetClient {
+    sf::UdpSocket socket;
+    sf::IpAddress serverAddress;
+    unsigned short serverPort = 0;
+
+    std::uint32_t inputSeq = 0; // Sequência da última entrada enviada
+    PlayerInput sentInput[NET_INPUT_WINDOW];
+    std::uint16_t sentBits[NET_INPUT_WINDOW] = {};
+    long long sentMicros[NET_INPUT_WINDOW] = {};
+    std::uint32_t lastMeasured = 0; // Última entrada com latência medida
+
+    NetState history[NET_HISTORY];
+    std::uint32_t newestTick = NET_NO_TICK;
+    std::vector<std::uint8_t> buffer;
+    NetStats stats;
+
+    bool start(const sf::IpAddress& address, unsigned short port);
+    bool connected() const { return newestTick != NET_NO_TICK; }
+
+    // Envia a entrada do tick e move o P2 da simulação espelho na hora (previsão)
+    void sendInput(Simulation& sim, const PlayerInput& p2, float dt);
+
+    // Lê os snapshots que chegaram, aplica o mais novo à simulação espelho e
+    // reconcilia o P2. Devolve true se algum snapshot novo foi aplicado.
+    bool poll(Simulation& sim, float dt);
+};
+
+// Modos headless de teste (ver uso acima). Retornam o código de saída.
+int runNetServerHeadless(unsigned short port, long long ticks, int initialZombies);
+int runNetClientHeadless(const sf::IpAddress& address, unsigned short port, long long ticks);
@@ -0,0 +1,208 @@
+#include "particles.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+void ParticleSystem::init(size_t capacity, std::uint64_t seed) {
+    x.resize(capacity);
+    y.resize(capacity);
+    vx.resize(capacity);
+    vy.resize(capacity);
+    age.resize(capacity);
+    life.resize(capacity);
+    size.resize(capacity);
+    drag.resize(capacity);
+    color.resize(capacity);
+    count = 0;
+    rng.seed(seed, 77u);
+    emitScale = 1.f;
+    dropped = 0;
+    vertices.resize(capacity * 6); // Reservado agora; só encolhe e volta a crescer dentro disso
+    vertices.resize(0);
+}
+
+void ParticleSystem::clear() {
+    count = 0;
+    vertices.resize(0);
+}
+
+void ParticleSystem::emit(float px, float py, float pvx, float pvy, float plife, float psize, float pdrag, sf::Color c) {
+    if (count == capacity()) {
+        dropped++;
+        return;
+    }
+    size_t i = count++;
+    x[i] = px;
+    y[i] = py;
+    vx[i] = pvx;
+    vy[i] = pvy;
+    age[i] = 0.f;
+    life[i] = plife;
+    size[i] = psize;
+    drag[i] = pdrag;
+    color[i] = c;
+}
+
+// Quantidade de partículas de um efeito depois do corte do orçamento (pelo menos 1)
+int ParticleSystem::scaled(int n) const {
+    return std::max(1, static_cast<int>(n * emitScale + 0.5f));
+}
+
+void ParticleSystem::emitEvents(const std::vector<SimEvent>& events) {
+    for (const SimEvent& e : events) {
+        switch (e.type) {
+            case EventShot: {
+                // Clarão: faíscas rápidas num cone estreito à frente do cano
+                float baseAngle = std::atan2(e.dirY, e.dirX);
+                float mx = e.x + e.dirX * 14.f;
+                float my = e.y + e.dirY * 14.f;
+                int n = scaled(6);
+                for (int k = 0; k < n; ++k) {
+                    float a = baseAngle + range(-0.35f, 0.35f);
+                    float speed = range(150.f, 350.f);
+                    sf::Uint8 g = static_cast<sf::Uint8>(range(190.f, 255.f));
+                    emit(mx, my, std::cos(a) * speed, std::sin(a) * speed, range(0.06f, 0.14f), range(2.f, 4.f), 6.f,
+                         sf::Color(255, g, 120));
+                }
+                break;
+            }
+            case EventZombieKilled: {
+                // Sangue: espirra na direção do golpe e para no chão
+                float baseAngle = std::atan2(e.dirY, e.dirX);
+                int n = scaled(24);
+                for (int k = 0; k < n; ++k) {
+                    float a = baseAngle + range(-1.1f, 1.1f);
+                    float speed = range(40.f, 220.f);
+                    sf::Uint8 r = static_cast<sf::Uint8>(range(110.f, 200.f));
+                    emit(e.x, e.y, std::cos(a) * speed, std::sin(a) * speed, range(0.4f, 0.9f), range(2.f, 4.5f), 4.f,
+                         sf::Color(r, 0, 0));
+                }
+                break;
+            }
+            case EventExplosion: {
+                // Onda de choque: anel que chega ao raio do dano, mais brasas soltas
+                const float ringLife = 0.35f;
+                int ring = scaled(180);
+                for (int k = 0; k < ring; ++k) {
+                    float a = static_cast<float>(2.0 * M_PI * k / ring);
+                    float speed = e.radius / ringLife;
+                    emit(e.x, e.y, std::cos(a) * speed, std::sin(a) * speed, ringLife, 5.f, 0.f, sf::Color(255, 165, 0));
+                }
+                int embers = scaled(60);
+                for (int k = 0; k < embers; ++k) {
+                    float a = range(0.f, static_cast<float>(2.0 * M_PI));
+                    float speed = range(20.f, e.radius * 1.5f);
+                    emit(e.x, e.y, std::cos(a) * speed, std::sin(a) * speed, range(0.3f, 0.8f), range(2.f, 5.f), 2.5f,
+                         sf::Color(255, static_cast<sf::Uint8>(range(60.f, 200.f)), 0));
+                }
+                break;
+            }
+        }
+    }
+}
+
+void ParticleSystem::update(float dt) {
+    auto start = std::chrono::steady_clock::now();
+    size_t i = 0;
+    while (i < count) {
+        age[i] += dt;
+        if (age[i] >= life[i]) {
+            // Swap-and-pop: a última ocupa o lugar e é processada nesta mesma volta
+            size_t last = --count;
+            x[i] = x[last];
+            y[i] = y[last];
+            vx[i] = vx[last];
+            vy[i] = vy[last];
+            age[i] = age[last];
+            life[i] = life[last];
+            size[i] = size[last];
+            drag[i] = drag[last];
+            color[i] = color[last];
+            continue;
+        }
+        float keep = std::max(0.f, 1.f - drag[i] * dt);
+        vx[i] *= keep;
+        vy[i] *= keep;
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+        ++i;
+    }
+    updateMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void ParticleSystem::build(const sf::FloatRect& view, sf::Vector2f whiteTexel, JobSystem* jobs) {
+    auto start = std::chrono::steady_clock::now();
+    const float right = view.left + view.width;
+    const float bottom = view.top + view.height;
+    auto visible = [&](size_t i) {
+        float h = size[i] * 0.5f;
+        return x[i] + h >= view.left && x[i] - h <= right && y[i] + h >= view.top && y[i] - h <= bottom;
+    };
+
+    // Como em BatchRenderer::buildZombies: conta as visíveis por bloco, soma
+    // de prefixos e monta os blocos (em paralelo com 'jobs'). Contar antes
+    // também faz o array mudar só pela diferença entre frames, em vez de
+    // crescer até o pool inteiro e encolher de novo.
+    const size_t blocks = (count + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN;
+    blockStart.resize(blocks + 1);
+    blockStart[0] = 0;
+
+    auto countBlocks = [&](size_t b0, size_t b1) {
+        for (size_t b = b0; b < b1; ++b) {
+            size_t end = std::min(count, (b + 1) * PARALLEL_GRAIN);
+            size_t n = 0;
+            for (size_t i = b * PARALLEL_GRAIN; i < end; ++i) n += visible(i) ? 1 : 0;
+            blockStart[b + 1] = n;
+        }
+    };
+
+    auto buildBlocks = [&](size_t b0, size_t b1) {
+        for (size_t b = b0; b < b1; ++b) {
+            size_t end = std::min(count, (b + 1) * PARALLEL_GRAIN);
+            sf::Vertex* v = &vertices[blockStart[b] * 6];
+            for (size_t i = b * PARALLEL_GRAIN; i < end; ++i) {
+                if (!visible(i)) continue;
+                float h = size[i] * 0.5f;
+                sf::Color c = color[i];
+                c.a = static_cast<sf::Uint8>(255.f * (1.f - age[i] / life[i]));
+                v[0] = sf::Vertex(sf::Vector2f(x[i] - h, y[i] - h), c, whiteTexel);
+                v[1] = sf::Vertex(sf::Vector2f(x[i] + h, y[i] - h), c, whiteTexel);
+                v[2] = sf::Vertex(sf::Vector2f(x[i] + h, y[i] + h), c, whiteTexel);
+                v[3] = v[0];
+                v[4] = v[2];
+                v[5] = sf::Vertex(sf::Vector2f(x[i] - h, y[i] + h), c, whiteTexel);
+                v += 6;
+            }
+        }
+    };
+
+    const bool parallel = jobs && count >= PARALLEL_MIN_ZOMBIES;
+    if (parallel) jobs->parallelFor(blocks, 1, countBlocks);
+    else countBlocks(0, blocks);
+    for (size_t b = 0; b < blocks; ++b) blockStart[b + 1] += blockStart[b];
+
+    const size_t visibleCount = blocks > 0 ? blockStart[blocks] : 0;
+    vertices.resize(visibleCount * 6);
+    if (visibleCount > 0) {
+        if (parallel) jobs->parallelFor(blocks, 1, buildBlocks);
+        else buildBlocks(0, blocks);
+    }
+
+    float buildMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    lastMs = updateMs + buildMs;
+    if (lastMs > PARTICLE_BUDGET_MS) {
+        emitScale = std::max(PARTICLE_MIN_EMIT_SCALE, emitScale * 0.75f);
+    } else if (lastMs < PARTICLE_BUDGET_MS * 0.5f) {
+        emitScale = std::min(1.f, emitScale + 0.02f);
+    }
+}
+
+void ParticleSystem::draw(DrawCounter& out, const sf::Texture& atlas) const {
+    if (vertices.getVertexCount() == 0) return;
+    out.draw(vertices, sf::RenderStates(&atlas));
+}
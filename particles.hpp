@@ -0,0 +1,76 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "render.hpp"
+#include "rng.hpp"
+#include "simulation.hpp"
+
+// Partículas só visuais (clarão dos tiros, sangue dos zumbis mortos, onda de
+// choque das explosões), geradas a partir de Simulation::events. Vivem fora
+// da simulação: não entram no hash, no snapshot nem no replay, e avançam com
+// o tempo do frame, não com o tick.
+//
+// Pool de capacidade fixa em arrays paralelos (structure-of-arrays), alocado
+// uma vez em init(): emitir é escrever no fim, morrer é trocar com a última
+// (swap-and-pop), então nenhuma partícula toca no heap. Todas viram quads num
+// único sf::VertexArray que amostra o texel branco do atlas: uma chamada de
+// desenho para qualquer quantidade.
+//
+// Orçamento: update() + build() são medidos a cada frame; acima de
+// PARTICLE_BUDGET_MS a quantidade emitida por evento cai (até
+// PARTICLE_MIN_EMIT_SCALE) e volta a subir aos poucos quando sobra tempo. Com
+// o pool cheio as emissões novas são descartadas e contadas.
+
+const size_t PARTICLE_CAPACITY = 1 << 16;
+const float PARTICLE_BUDGET_MS = 1.5f;
+const float PARTICLE_MIN_EMIT_SCALE = 0.1f;
+
+struct ParticleSystem {
+    // Um elemento por partícula viva em [0, count)
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> vx;
+    std::vector<float> vy;
+    std::vector<float> age;   // Segundos desde que nasceu
+    std::vector<float> life;  // Segundos de vida
+    std::vector<float> size;  // Lado do quad em px
+    std::vector<float> drag;  // Fração da velocidade perdida por segundo
+    std::vector<sf::Color> color; // Cor inicial; o alfa cai até 0 no fim da vida
+    size_t count = 0;
+
+    Rng rng; // Sorteios dos efeitos (separado do da simulação)
+    float emitScale = 1.f;
+    float lastMs = 0.f;     // update() + build() do último frame
+    long long dropped = 0;  // Partículas que não couberam no pool
+
+    sf::VertexArray vertices{sf::Triangles};
+    std::vector<size_t> blockStart; // Primeiro quad de cada bloco de partículas visíveis
+
+    void init(size_t capacity, std::uint64_t seed);
+    void clear();
+
+    size_t capacity() const { return x.size(); }
+
+    // Cria as partículas dos eventos de um tick
+    void emitEvents(const std::vector<SimEvent>& events);
+
+    // Avança 'dt' segundos e remove as que acabaram
+    void update(float dt);
+
+    // Monta os quads das partículas que tocam 'view' (efeitos não entram em
+    // CullStats); com 'jobs', pools grandes são montados em blocos paralelos
+    void build(const sf::FloatRect& view, sf::Vector2f whiteTexel, JobSystem* jobs = nullptr);
+
+    // Uma chamada de desenho (com o atlas, como os lotes de zumbis e balas)
+    void draw(DrawCounter& out, const sf::Texture& atlas) const;
+
+private:
+    float updateMs = 0.f;
+
+    void emit(float px, float py, float pvx, float pvy, float plife, float psize, float pdrag, sf::Color c);
+    int scaled(int n) const;
+    float range(float lo, float hi) { return lo + (hi - lo) * rng.unit(); }
+};
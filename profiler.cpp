@@ -0,0 +1,78 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+Profiler g_profiler;
+
+const char* profilePhaseName(ProfilePhase phase) {
+    switch (phase) {
+        case PhaseEvents: return "eventos";
+        case PhaseAbilities: return "habilidades";
+        case PhaseSpawn: return "spawn";
+        case PhaseMovement: return "movimento";
+        case PhaseBulletCollision: return "colisao_balas";
+        case PhaseBarricadeCollision: return "colisao_barricadas";
+        case PhaseParticles: return "particulas";
+        case PhaseHud: return "hud";
+        case PhaseRender: return "render";
+        case PhaseFrame: return "frame";
+        default: return "?";
+    }
+}
+
+void Profiler::setEnabled(bool on) {
+    if (on && ring.empty()) ring.resize(PROFILER_RING_CAPACITY);
+    enabled = on;
+    beginFrame();
+}
+
+void Profiler::beginFrame() {
+    for (std::atomic<long long>& n : frameNanos) n.store(0, std::memory_order_relaxed);
+}
+
+void Profiler::endFrame(int zombies, int bullets, int barricades) {
+    if (!enabled) return;
+    unsigned long long n = written.load(std::memory_order_relaxed);
+    FrameSample& s = ring[n % PROFILER_RING_CAPACITY];
+    s.frame = n;
+    for (int p = 0; p < PhaseCount; ++p) {
+        s.phaseMs[p] = static_cast<float>(frameNanos[p].exchange(0, std::memory_order_relaxed) / 1e6);
+    }
+    s.zombies = zombies;
+    s.bullets = bullets;
+    s.barricades = barricades;
+    // Publica a amostra só depois de escrita
+    written.store(n + 1, std::memory_order_release);
+}
+
+size_t Profiler::recentSamples(FrameSample* out, size_t max) const {
+    unsigned long long n = written.load(std::memory_order_acquire);
+    size_t count = static_cast<size_t>(std::min<unsigned long long>({ n, max, PROFILER_RING_CAPACITY }));
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = ring[(n - count + i) % PROFILER_RING_CAPACITY];
+    }
+    return count;
+}
+
+bool Profiler::writeCsv(const char* path) const {
+    unsigned long long n = written.load(std::memory_order_acquire);
+    if (n == 0) return false;
+
+    std::FILE* f = std::fopen(path, "w");
+    if (!f) return false;
+
+    std::fprintf(f, "frame");
+    for (int p = 0; p < PhaseCount; ++p) std::fprintf(f, ",%s_ms", profilePhaseName(static_cast<ProfilePhase>(p)));
+    std::fprintf(f, ",zumbis,balas,barricadas\n");
+
+    unsigned long long first = n > PROFILER_RING_CAPACITY ? n - PROFILER_RING_CAPACITY : 0;
+    for (unsigned long long i = first; i < n; ++i) {
+        const FrameSample& s = ring[i % PROFILER_RING_CAPACITY];
+        std::fprintf(f, "%llu", s.frame);
+        for (int p = 0; p < PhaseCount; ++p) std::fprintf(f, ",%.4f", s.phaseMs[p]);
+        std::fprintf(f, ",%d,%d,%d\n", s.zombies, s.bullets, s.barricades);
+    }
+    std::fclose(f);
+    return true;
+}
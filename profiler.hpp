@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+// Profiler por fase do frame. Cada fase é medida com um ProfileScope (ou com
+// ProfileLap, para fases seguidas dentro da mesma função); os
+// tempos do frame são somados e, em endFrame(), viram uma amostra num anel
+// sem locks (um produtor; leitores copiam as amostras mais recentes). Com o
+// profiler desligado um ProfileScope custa só a leitura de um bool.
+// No jogo: F3 liga/desliga o overlay; --profile [arquivo.csv] já começa
+// ligado. As amostras coletadas são gravadas em CSV ao sair.
+
+enum ProfilePhase {
+    PhaseEvents,             // Eventos da janela
+    PhaseAbilities,          // Habilidades
+    PhaseSpawn,              // Spawn de zumbis e waves
+    PhaseMovement,           // Players, campo de fluxo e zumbis
+    PhaseBulletCollision,    // Balas e efeitos de área: grade e acertos
+    PhaseBarricadeCollision, // Zumbis vs barricadas, base e players
+    PhaseParticles,          // Emissão e atualização das partículas
+    PhaseHud,                // Atualização do HUD
+    PhaseRender,             // Montagem e desenho do frame
+    PhaseFrame,              // Frame inteiro
+    PhaseCount
+};
+
+const char* profilePhaseName(ProfilePhase phase);
+
+// Uma amostra por frame
+struct FrameSample {
+    unsigned long long frame = 0;
+    float phaseMs[PhaseCount] = {};
+    int zombies = 0;
+    int bullets = 0;
+    int barricades = 0;
+};
+
+// Amostras guardadas (~7 minutos a 144 FPS); as mais antigas são sobrescritas
+const size_t PROFILER_RING_CAPACITY = 1 << 16;
+
+struct Profiler {
+    // Atômicos porque a simulação (em outra thread) soma as fases do tick
+    // enquanto a renderização fecha os frames
+    std::atomic<bool> enabled{false};
+
+    // Liga/desliga a coleta (o anel é alocado na primeira vez que liga)
+    void setEnabled(bool on);
+
+    void beginFrame();
+    void add(ProfilePhase phase, long long nanos) { frameNanos[phase].fetch_add(nanos, std::memory_order_relaxed); }
+    void endFrame(int zombies, int bullets, int barricades);
+
+    // Frames publicados desde o início (inclui os já sobrescritos no anel)
+    unsigned long long frameCount() const { return written.load(std::memory_order_acquire); }
+
+    // Copia as até 'max' amostras mais recentes, da mais antiga para a mais nova
+    size_t recentSamples(FrameSample* out, size_t max) const;
+
+    // Grava as amostras guardadas em CSV; false se não havia amostras ou o arquivo falhou
+    bool writeCsv(const char* path) const;
+
+private:
+    std::atomic<long long> frameNanos[PhaseCount] = {};
+    std::vector<FrameSample> ring;
+    std::atomic<unsigned long long> written{0};
+};
+
+extern Profiler g_profiler;
+
+// Mede o tempo de vida do escopo e soma na fase dada
+struct ProfileScope {
+    ProfilePhase phase;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+
+    explicit ProfileScope(ProfilePhase p) : phase(p), active(g_profiler.enabled) {
+        if (active) start = std::chrono::steady_clock::now();
+    }
+    ~ProfileScope() {
+        if (!active) return;
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        g_profiler.add(phase, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+// Para fases em sequência: mark(fase) soma na fase o tempo desde a marca anterior
+struct ProfileLap {
+    bool active;
+    std::chrono::steady_clock::time_point last;
+
+    ProfileLap() : active(g_profiler.enabled) {
+        if (active) last = std::chrono::steady_clock::now();
+    }
+    // Recomeça a contar sem somar em nenhuma fase
+    void reset() {
+        if (active) last = std::chrono::steady_clock::now();
+    }
+    void mark(ProfilePhase phase) {
+        if (!active) return;
+        auto now = std::chrono::steady_clock::now();
+        g_profiler.add(phase, std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count());
+        last = now;
+    }
+};
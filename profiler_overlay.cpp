@@ -0,0 +1,55 @@
+#include "profiler_overlay.hpp"
+
+#include <algorithm>
+
+void ProfilerOverlay::init(const sf::Font& font) {
+    hud.init(font, 16);
+    const sf::Color color(255, 220, 0);
+    titleLabel = hud.addScreenLabel(16, sf::Vector2f(0.f, 0.f), color);
+    for (int p = 0; p < PhaseCount; ++p) {
+        phaseLabels[p] = hud.addScreenLabel(14, sf::Vector2f(0.f, 0.f), color);
+    }
+    countsLabel = hud.addScreenLabel(14, sf::Vector2f(0.f, 0.f), color);
+
+    hud.setPosition(titleLabel, sf::Vector2f(10.f, 90.f));
+    for (int p = 0; p < PhaseCount; ++p) {
+        hud.setPosition(phaseLabels[p], sf::Vector2f(10.f, 112.f + 17.f * p));
+    }
+    hud.setPosition(countsLabel, sf::Vector2f(10.f, 116.f + 17.f * PhaseCount));
+
+    samples.resize(PROFILER_OVERLAY_FRAMES);
+    sorted.reserve(PROFILER_OVERLAY_FRAMES);
+    refreshClock.restart();
+}
+
+void ProfilerOverlay::update(const Profiler& profiler, const sf::View& view) {
+    if (refreshClock.getElapsedTime().asSeconds() >= 0.25f) {
+        refreshClock.restart();
+        size_t n = profiler.recentSamples(samples.data(), samples.size());
+
+        hud.setText(titleLabel, HudFormat().text("profiler: ").number(static_cast<long long>(n)).text(" frames (F3)"));
+        for (int p = 0; p < PhaseCount; ++p) {
+            sorted.clear();
+            double sum = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                sorted.push_back(samples[i].phaseMs[p]);
+                sum += samples[i].phaseMs[p];
+            }
+            double avg = n > 0 ? sum / n : 0.0;
+            double p99 = 0.0;
+            if (n > 0) {
+                size_t k = std::min(n - 1, n * 99 / 100);
+                std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+                p99 = sorted[k];
+            }
+            hud.setText(phaseLabels[p], HudFormat().text(profilePhaseName(static_cast<ProfilePhase>(p)))
+                                                   .text(": ").fixed(avg, 3).text(" ms  p99 ").fixed(p99, 3).text(" ms"));
+        }
+
+        const FrameSample* last = n > 0 ? &samples[n - 1] : nullptr;
+        hud.setText(countsLabel, HudFormat().text("zumbis ").number(last ? last->zombies : 0)
+                                            .text("  balas ").number(last ? last->bullets : 0)
+                                            .text("  barricadas ").number(last ? last->barricades : 0));
+    }
+    hud.update(view);
+}
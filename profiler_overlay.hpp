@@ -0,0 +1,31 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+#include "hud.hpp"
+#include "profiler.hpp"
+
+// Frames usados nas estatísticas do overlay (média e p99)
+const size_t PROFILER_OVERLAY_FRAMES = 240;
+
+// Overlay do profiler (F3): média e p99 de cada fase nos últimos frames e a
+// contagem de entidades. Usa o mesmo HUD em lote e só troca os textos algumas
+// vezes por segundo, para o próprio overlay não pesar no frame.
+struct ProfilerOverlay {
+    Hud hud;
+    int titleLabel = -1;
+    int phaseLabels[PhaseCount];
+    int countsLabel = -1;
+
+    std::vector<FrameSample> samples;
+    std::vector<float> sorted;
+    sf::Clock refreshClock;
+
+    void init(const sf::Font& font);
+
+    // Recalcula as estatísticas (no máximo 4x por segundo) e posiciona na view
+    void update(const Profiler& profiler, const sf::View& view);
+
+    void draw(DrawCounter& out) const { hud.draw(out); }
+};
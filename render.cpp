@@ -0,0 +1,180 @@
+#include "render.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Lados do polígono usado para desenhar cada bala
+static const int BULLET_SEGMENTS = 8;
+static const int EFFECT_SEGMENTS = 30; // Triângulos do leque de cada efeito de área
+
+void BatchRenderer::buildZombies(const ZombieStore& zombies, const sf::IntRect& sprite, float alpha,
+                                 const sf::FloatRect& view, CullStats& stats, JobSystem* jobs) {
+    const size_t count = zombies.size();
+    if (count == 0) {
+        zombieVertices.resize(0);
+        return;
+    }
+
+    float u0 = static_cast<float>(sprite.left);
+    float v0 = static_cast<float>(sprite.top);
+    float u1 = static_cast<float>(sprite.left + sprite.width);
+    float v1 = static_cast<float>(sprite.top + sprite.height);
+
+    // Blocos de PARALLEL_GRAIN zumbis: a primeira passada conta os visíveis de
+    // cada bloco, a soma de prefixos dá onde cada bloco escreve e a segunda
+    // passada monta os quads. A ordem dos quads é a dos zumbis, com qualquer
+    // número de threads.
+    const size_t blocks = (count + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN;
+    zombieBlockStart.resize(blocks + 1);
+    zombieBlockStart[0] = 0;
+
+    auto positionAt = [&](size_t i, float& zx, float& zy) {
+        zx = zombies.prevX[i] + (zombies.x[i] - zombies.prevX[i]) * alpha;
+        zy = zombies.prevY[i] + (zombies.y[i] - zombies.prevY[i]) * alpha;
+    };
+
+    auto countBlocks = [&](size_t b0, size_t b1) {
+        for (size_t b = b0; b < b1; ++b) {
+            size_t end = std::min(count, (b + 1) * PARALLEL_GRAIN);
+            size_t visible = 0;
+            for (size_t i = b * PARALLEL_GRAIN; i < end; ++i) {
+                float zx, zy;
+                positionAt(i, zx, zy);
+                visible += circleVisible(view, zx, zy, zombies.radius[i]) ? 1 : 0;
+            }
+            zombieBlockStart[b + 1] = visible;
+        }
+    };
+
+    auto buildBlocks = [&](size_t b0, size_t b1) {
+        sf::Vertex* out = &zombieVertices[0];
+        for (size_t b = b0; b < b1; ++b) {
+            size_t end = std::min(count, (b + 1) * PARALLEL_GRAIN);
+            sf::Vertex* v = out + zombieBlockStart[b] * 6;
+            for (size_t i = b * PARALLEL_GRAIN; i < end; ++i) {
+                float r = zombies.radius[i];
+                float zx, zy;
+                positionAt(i, zx, zy);
+                if (!circleVisible(view, zx, zy, r)) continue;
+                float left = zx - r;
+                float right = zx + r;
+                float top = zy - r;
+                float bottom = zy + r;
+
+                // Dois triângulos por quad
+                v[0] = sf::Vertex(sf::Vector2f(left, top), sf::Vector2f(u0, v0));
+                v[1] = sf::Vertex(sf::Vector2f(right, top), sf::Vector2f(u1, v0));
+                v[2] = sf::Vertex(sf::Vector2f(right, bottom), sf::Vector2f(u1, v1));
+                v[3] = v[0];
+                v[4] = v[2];
+                v[5] = sf::Vertex(sf::Vector2f(left, bottom), sf::Vector2f(u0, v1));
+                v += 6;
+            }
+        }
+    };
+
+    const bool parallel = jobs && count >= PARALLEL_MIN_ZOMBIES;
+    if (parallel) jobs->parallelFor(blocks, 1, countBlocks);
+    else countBlocks(0, blocks);
+
+    for (size_t b = 0; b < blocks; ++b) zombieBlockStart[b + 1] += zombieBlockStart[b];
+    const size_t visible = zombieBlockStart[blocks];
+    stats.drawn += static_cast<int>(visible);
+    stats.culled += static_cast<int>(count - visible);
+
+    zombieVertices.resize(visible * 6);
+    if (visible == 0) return;
+    if (parallel) jobs->parallelFor(blocks, 1, buildBlocks);
+    else buildBlocks(0, blocks);
+}
+
+void BatchRenderer::buildBullets(const BulletPool& bullets, float alpha, sf::Color p1Color, sf::Color p2Color,
+                                 sf::Vector2f whiteTexel, const sf::FloatRect& view, CullStats& stats) {
+    // Pontos do octógono unitário, calculados uma vez
+    static sf::Vector2f unit[BULLET_SEGMENTS + 1];
+    static bool unitReady = false;
+    if (!unitReady) {
+        for (int k = 0; k <= BULLET_SEGMENTS; ++k) {
+            float a = static_cast<float>(2.0 * M_PI * k / BULLET_SEGMENTS);
+            unit[k] = sf::Vector2f(std::cos(a), std::sin(a));
+        }
+        unitReady = true;
+    }
+
+    // Reserva para todas as balas ativas e encolhe para as visíveis no fim
+    bulletVertices.resize(static_cast<size_t>(bullets.size()) * BULLET_SEGMENTS * 3);
+
+    size_t n = 0;
+    const float r = BULLET_RADIUS;
+    for (const Bullet& b : bullets.slots) {
+        if (!b.active) continue;
+        // Centro na posição de colisão da bala
+        sf::Vector2f c = interpolate(b.prevPosition, b.position, alpha);
+        if (!stats.count(circleVisible(view, c.x, c.y, r))) continue;
+        sf::Color color = b.owner == OwnerPlayer1 ? p1Color : p2Color;
+
+        sf::Vertex* v = &bulletVertices[n * BULLET_SEGMENTS * 3];
+        for (int k = 0; k < BULLET_SEGMENTS; ++k) {
+            v[k * 3 + 0] = sf::Vertex(c, color, whiteTexel);
+            v[k * 3 + 1] = sf::Vertex(c + unit[k] * r, color, whiteTexel);
+            v[k * 3 + 2] = sf::Vertex(c + unit[k + 1] * r, color, whiteTexel);
+        }
+        n++;
+    }
+    bulletVertices.resize(n * BULLET_SEGMENTS * 3);
+}
+
+void BatchRenderer::buildEffects(const AreaEffectPool& effects, sf::Vector2f whiteTexel, const sf::FloatRect& view,
+                                 CullStats& stats) {
+    effectVertices.resize(effects.size() * EFFECT_SEGMENTS * 3);
+
+    size_t n = 0;
+    for (const AreaEffect& e : effects.items) {
+        if (!e.detonated) continue;
+        sf::Vector2f c = e.position;
+        float r = e.currentRadius;
+        if (!stats.count(circleVisible(view, c.x, c.y, r))) continue;
+        sf::Color color(255, 165, 0, static_cast<sf::Uint8>(std::max(0.f, std::min(255.f, e.alpha))));
+
+        // Disco inteiro, ou o arco de +-acos(coneCos) em volta do eixo
+        float start = 0.f;
+        float span = static_cast<float>(2.0 * M_PI);
+        if (e.shape == AreaCone) {
+            float half = std::acos(std::max(-1.f, std::min(1.f, e.coneCos)));
+            start = std::atan2(e.direction.y, e.direction.x) - half;
+            span = 2.f * half;
+        }
+
+        sf::Vertex* v = &effectVertices[n * EFFECT_SEGMENTS * 3];
+        sf::Vector2f prev = c + sf::Vector2f(std::cos(start), std::sin(start)) * r;
+        for (int k = 0; k < EFFECT_SEGMENTS; ++k) {
+            float a = start + span * (k + 1) / EFFECT_SEGMENTS;
+            sf::Vector2f next = c + sf::Vector2f(std::cos(a), std::sin(a)) * r;
+            v[k * 3 + 0] = sf::Vertex(c, color, whiteTexel);
+            v[k * 3 + 1] = sf::Vertex(prev, color, whiteTexel);
+            v[k * 3 + 2] = sf::Vertex(next, color, whiteTexel);
+            prev = next;
+        }
+        n++;
+    }
+    effectVertices.resize(n * EFFECT_SEGMENTS * 3);
+}
+
+void BatchRenderer::drawZombies(DrawCounter& out, const sf::Texture& atlas) const {
+    if (zombieVertices.getVertexCount() == 0) return;
+    out.draw(zombieVertices, sf::RenderStates(&atlas));
+}
+
+void BatchRenderer::drawBullets(DrawCounter& out, const sf::Texture& atlas) const {
+    if (bulletVertices.getVertexCount() == 0) return;
+    out.draw(bulletVertices, sf::RenderStates(&atlas));
+}
+
+void BatchRenderer::drawEffects(DrawCounter& out, const sf::Texture& atlas) const {
+    if (effectVertices.getVertexCount() == 0) return;
+    out.draw(effectVertices, sf::RenderStates(&atlas));
+}
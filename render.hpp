@@ -0,0 +1,98 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+#include "simulation.hpp"
+
+// Posição interpolada entre o tick anterior (alpha 0) e o atual (alpha 1)
+inline sf::Vector2f interpolate(sf::Vector2f prev, sf::Vector2f current, float alpha) {
+    return prev + (current - prev) * alpha;
+}
+
+// Retângulo do mundo visto pela view (o jogo não gira a câmera)
+inline sf::FloatRect viewBounds(const sf::View& view) {
+    sf::Vector2f size = view.getSize();
+    sf::Vector2f center = view.getCenter();
+    return sf::FloatRect(center.x - size.x / 2.f, center.y - size.y / 2.f, size.x, size.y);
+}
+
+// Círculo (centro e raio) com alguma parte dentro de 'bounds'
+inline bool circleVisible(const sf::FloatRect& bounds, float x, float y, float r) {
+    return x + r >= bounds.left && x - r <= bounds.left + bounds.width &&
+           y + r >= bounds.top && y - r <= bounds.top + bounds.height;
+}
+
+// Barricada (centro em 'position') com o texto de vida acima dela, com alguma
+// parte dentro de 'bounds'
+inline bool barricadeVisible(const sf::FloatRect& bounds, sf::Vector2f position) {
+    const float labelSpace = 24.f; // Texto de vida 10 px acima da barricada
+    sf::FloatRect area(position.x - BARRICADE_SIZE.x / 2.f, position.y - BARRICADE_SIZE.y / 2.f - labelSpace,
+                       BARRICADE_SIZE.x, BARRICADE_SIZE.y + labelSpace);
+    return bounds.intersects(area);
+}
+
+inline bool barricadeVisible(const sf::FloatRect& bounds, const Barricade& bar) {
+    return barricadeVisible(bounds, bar.shape.getPosition());
+}
+
+// Entidades que chegaram a ser desenhadas e as descartadas por estarem fora da view
+struct CullStats {
+    int drawn = 0;
+    int culled = 0;
+
+    // Conta uma entidade; devolve se ela é visível
+    bool count(bool visible) {
+        if (visible) drawn++;
+        else culled++;
+        return visible;
+    }
+};
+
+// Repassa as chamadas de desenho para o alvo e conta quantas houve no frame
+struct DrawCounter {
+    sf::RenderTarget& target;
+    int calls = 0;
+
+    explicit DrawCounter(sf::RenderTarget& t) : target(t) {}
+
+    void draw(const sf::Drawable& drawable, const sf::RenderStates& states = sf::RenderStates::Default) {
+        target.draw(drawable, states);
+        calls++;
+    }
+};
+
+// Renderização em lote: todos os zumbis viram quads texturizados em um único
+// sf::VertexArray e todas as balas viram octógonos em outro, então o número
+// de chamadas de desenho por frame não cresce com o número de entidades.
+// Os dois lotes amostram a mesma textura (o atlas de assets.hpp): as balas
+// usam o texel branco, então não há troca de textura entre eles.
+// Os arrays são reaproveitados entre frames (só crescem). Só entram nos
+// arrays as entidades que tocam 'view' (o retângulo de viewBounds()).
+struct BatchRenderer {
+    sf::VertexArray zombieVertices{sf::Triangles};
+    sf::VertexArray bulletVertices{sf::Triangles};
+    sf::VertexArray effectVertices{sf::Triangles};
+    std::vector<size_t> zombieBlockStart; // Primeiro quad de cada bloco de zumbis visíveis
+
+    // Monta os quads dos zumbis visíveis com o sprite (região do atlas) no
+    // diâmetro de cada um, na posição interpolada por 'alpha'; com 'jobs',
+    // hordas grandes são montadas em blocos paralelos
+    void buildZombies(const ZombieStore& zombies, const sf::IntRect& sprite, float alpha,
+                      const sf::FloatRect& view, CullStats& stats, JobSystem* jobs = nullptr);
+
+    // Monta as balas visíveis como octógonos na cor do player dono de cada
+    // uma; todos os vértices apontam para 'whiteTexel' no atlas
+    void buildBullets(const BulletPool& bullets, float alpha, sf::Color p1Color, sf::Color p2Color,
+                      sf::Vector2f whiteTexel, const sf::FloatRect& view, CullStats& stats);
+
+    // Monta os efeitos de área já detonados e visíveis (leques de
+    // triângulos: disco inteiro ou só o setor do cone) no raio atual, com o
+    // alfa do fade; também pelo texel branco
+    void buildEffects(const AreaEffectPool& effects, sf::Vector2f whiteTexel, const sf::FloatRect& view, CullStats& stats);
+
+    // Desenha os zumbis, as balas e os efeitos (uma chamada cada)
+    void drawZombies(DrawCounter& out, const sf::Texture& atlas) const;
+    void drawBullets(DrawCounter& out, const sf::Texture& atlas) const;
+    void drawEffects(DrawCounter& out, const sf::Texture& atlas) const;
+};
@@ -0,0 +1,76 @@
+#include "render_snapshot.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+void captureRenderSnapshot(const Simulation& sim, RenderSnapshot& out) {
+    const Player* players[2] = { &sim.player1, &sim.player2 };
+    for (int k = 0; k < 2; ++k) {
+        out.players[k].prevPosition = players[k]->prevPosition;
+        out.players[k].position = players[k]->shape.getPosition();
+        out.players[k].alive = players[k]->alive;
+        out.players[k].abilityTimer = players[k]->abilityTimer;
+    }
+
+    // assign() reaproveita a capacidade do buffer
+    const ZombieStore& zs = sim.zombies;
+    out.zombies.x.assign(zs.x.begin(), zs.x.end());
+    out.zombies.y.assign(zs.y.begin(), zs.y.end());
+    out.zombies.prevX.assign(zs.prevX.begin(), zs.prevX.end());
+    out.zombies.prevY.assign(zs.prevY.begin(), zs.prevY.end());
+    out.zombies.radius.assign(zs.radius.begin(), zs.radius.end());
+
+    out.bullets.slots.assign(sim.bullets.slots.begin(), sim.bullets.slots.end());
+    out.bullets.count = sim.bullets.count;
+
+    out.barricades.resize(sim.barricades.size());
+    for (size_t j = 0; j < sim.barricades.size(); ++j) {
+        const Barricade& bar = sim.barricades[j];
+        out.barricades[j].position = bar.shape.getPosition();
+        out.barricades[j].health = bar.health;
+        out.barricades[j].maxHealth = bar.maxHealth;
+    }
+
+    out.effects.items.assign(sim.effects.items.begin(), sim.effects.items.end());
+    out.wave = sim.currentWave;
+    out.zombiesRemaining = sim.zombiesRemaining;
+    out.gameOver = sim.gameOver;
+}
+
+void LatencyStats::init(size_t capacity) {
+    samples.clear();
+    samples.reserve(capacity);
+    sorted.reserve(capacity);
+    next = 0;
+    total = 0;
+}
+
+void LatencyStats::add(float ms) {
+    if (samples.size() < samples.capacity()) {
+        samples.push_back(ms);
+    } else if (!samples.empty()) {
+        samples[next] = ms;
+        next = (next + 1) % samples.size();
+    }
+    total++;
+}
+
+float LatencyStats::percentile(float p) const {
+    if (samples.empty()) return 0.f;
+    sorted.assign(samples.begin(), samples.end());
+    size_t k = static_cast<size_t>(p * (sorted.size() - 1));
+    std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+    return sorted[k];
+}
+
+void LatencyStats::print(const char* label) const {
+    if (samples.empty()) return;
+    double sum = 0.0;
+    float maxMs = 0.f;
+    for (float v : samples) {
+        sum += v;
+        maxMs = std::max(maxMs, v);
+    }
+    std::printf("  %-22s media %.2f ms, p50 %.2f ms, p99 %.2f ms, max %.2f ms (%lld amostras)\n", label,
+                sum / samples.size(), percentile(0.5f), percentile(0.99f), maxMs, total);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "simulation.hpp"
+
+// Foto do mundo que a thread da simulação publica para a de renderização
+// (por um TripleBuffer): só o que o frame desenha e o HUD mostra. Depois de
+// publicada ninguém a altera; a renderização lê sem travar a simulação.
+// Os vetores são reaproveitados entre publicações, então depois das
+// primeiras fotos copiar o mundo não aloca memória.
+
+struct RenderPlayer {
+    sf::Vector2f prevPosition;
+    sf::Vector2f position;
+    bool alive = false;
+    float abilityTimer = 0.f;
+};
+
+struct RenderBarricade {
+    sf::Vector2f position;
+    int health = 0;
+    int maxHealth = 0;
+};
+
+struct RenderSnapshot {
+    std::uint64_t sequence = 0;  // Número da publicação
+    std::uint32_t epoch = 0;     // Último comando da renderização já aplicado pela simulação
+    std::uint32_t worldResets = 0; // Muda quando o mundo é trocado (partida nova, quickload, rewind)
+    long long tick = 0;          // Ticks desde o começo da partida
+    std::int64_t publishedNs = 0; // steady_clock na publicação
+    float tickDt = 0.f;
+    float alphaAtPublish = 0.f;  // Fração do próximo tick já passada quando publicou
+    bool running = false;        // Ticks andando (partida em curso, sem pause nem game over)
+    bool gameOver = false;
+
+    RenderPlayer players[2];
+    ZombieStore zombies; // Só x, y, prevX, prevY e radius
+    BulletPool bullets;
+    std::vector<RenderBarricade> barricades;
+    AreaEffectPool effects;
+    int wave = 0;
+    int zombiesRemaining = 0;
+
+    // Eventos de todos os ticks desde a última foto que a renderização leu
+    // (as puladas passam os eventos adiante, então nenhum efeito se perde)
+    std::vector<SimEvent> events;
+
+    // Métricas da simulação no momento da publicação
+    float tickMs = 0.f;     // Duração do último tick
+    float tickLateMs = 0.f; // Quanto o último tick começou depois da hora
+};
+
+// Copia o estado desenhável de 'sim' para 'out' (não mexe nos eventos nem
+// nos campos de controle e métricas, preenchidos por quem publica)
+void captureRenderSnapshot(const Simulation& sim, RenderSnapshot& out);
+
+// Amostras de latência em anel de capacidade fixa (as mais antigas são
+// descartadas), com média e percentis das guardadas
+struct LatencyStats {
+    std::vector<float> samples;
+    size_t next = 0;
+    long long total = 0; // Amostras vistas desde o início
+
+    void init(size_t capacity);
+    void add(float ms);
+
+    // Percentil p em [0, 1] das amostras guardadas (0 sem amostras)
+    float percentile(float p) const;
+
+    // "rotulo: media X ms, p50 ..., p99 ..., max ... (N amostras)"
+    void print(const char* label) const;
+
+private:
+    mutable std::vector<float> sorted;
+};
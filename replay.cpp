@@ -0,0 +1,173 @@
+#include "replay.hpp"
+#include "fixed_step.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+std::uint16_t packPlayerInput(const PlayerInput& p) {
+    return static_cast<std::uint16_t>((p.up ? 1 : 0) | (p.down ? 2 : 0) | (p.left ? 4 : 0) |
+                                      (p.right ? 8 : 0) | (p.shoot ? 16 : 0) | (p.ability ? 32 : 0));
+}
+
+PlayerInput unpackPlayerInput(std::uint16_t bits) {
+    PlayerInput p;
+    p.up = (bits & 1) != 0;
+    p.down = (bits & 2) != 0;
+    p.left = (bits & 4) != 0;
+    p.right = (bits & 8) != 0;
+    p.shoot = (bits & 16) != 0;
+    p.ability = (bits & 32) != 0;
+    return p;
+}
+
+std::uint16_t packInput(const TickInput& in) {
+    return static_cast<std::uint16_t>(packPlayerInput(in.p1) | (packPlayerInput(in.p2) << 6));
+}
+
+TickInput unpackInput(std::uint16_t bits) {
+    TickInput in;
+    in.p1 = unpackPlayerInput(bits & 63);
+    in.p2 = unpackPlayerInput((bits >> 6) & 63);
+    return in;
+}
+
+std::uint32_t replayHash(const Simulation& sim) {
+    std::uint64_t h = hashSimulation(sim);
+    return static_cast<std::uint32_t>(h ^ (h >> 32));
+}
+
+void ReplayRecorder::begin(std::uint64_t gameSeed, int rate) {
+    seed = gameSeed;
+    tickRate = rate;
+    runs.clear();
+    hashes.clear();
+    hashes.reserve(static_cast<size_t>(rate) * 60 * 10); // Dez minutos sem realocar
+}
+
+void ReplayRecorder::record(const TickInput& in, const Simulation& sim) {
+    std::uint16_t bits = packInput(in);
+    if (!runs.empty() && runs.back().input == bits && runs.back().length < 0xFFFF) {
+        runs.back().length++;
+    } else {
+        runs.push_back(ReplayRun{bits, 1});
+    }
+    hashes.push_back(replayHash(sim));
+}
+
+// Inteiros gravados byte a byte, independente da ordem de bytes da máquina
+static void putBytes(std::vector<unsigned char>& out, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+}
+
+static std::uint64_t getBytes(const unsigned char* p, int bytes) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) value |= static_cast<std::uint64_t>(p[i]) << (8 * i);
+    return value;
+}
+
+const size_t REPLAY_HEADER_SIZE = 4 + 2 + 2 + 8 + 4 + 4;
+
+bool ReplayRecorder::save(const char* path) const {
+    std::vector<unsigned char> out;
+    out.reserve(REPLAY_HEADER_SIZE + runs.size() * 4 + hashes.size() * 4);
+    out.insert(out.end(), { 'Z', 'R', 'P', 'L' });
+    putBytes(out, REPLAY_VERSION, 2);
+    putBytes(out, static_cast<std::uint64_t>(tickRate), 2);
+    putBytes(out, seed, 8);
+    putBytes(out, hashes.size(), 4);
+    putBytes(out, runs.size(), 4);
+    for (const ReplayRun& r : runs) {
+        putBytes(out, r.input, 2);
+        putBytes(out, r.length, 2);
+    }
+    for (std::uint32_t h : hashes) putBytes(out, h, 4);
+
+    std::FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(out.data(), 1, out.size(), f) == out.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+bool Replay::load(const char* path) {
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) return false;
+    std::vector<unsigned char> data;
+    unsigned char chunk[4096];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) data.insert(data.end(), chunk, chunk + n);
+    std::fclose(f);
+
+    if (data.size() < REPLAY_HEADER_SIZE || std::memcmp(data.data(), "ZRPL", 4) != 0) return false;
+    const unsigned char* p = data.data() + 4;
+    if (getBytes(p, 2) != REPLAY_VERSION) return false;
+    tickRate = static_cast<int>(getBytes(p + 2, 2));
+    seed = getBytes(p + 4, 8);
+    size_t ticks = static_cast<size_t>(getBytes(p + 12, 4));
+    size_t runCount = static_cast<size_t>(getBytes(p + 16, 4));
+    if (tickRate <= 0 || data.size() != REPLAY_HEADER_SIZE + runCount * 4 + ticks * 4) return false;
+
+    p = data.data() + REPLAY_HEADER_SIZE;
+    inputs.clear();
+    inputs.reserve(ticks);
+    for (size_t r = 0; r < runCount; ++r, p += 4) {
+        std::uint16_t bits = static_cast<std::uint16_t>(getBytes(p, 2));
+        size_t length = static_cast<size_t>(getBytes(p + 2, 2));
+        inputs.insert(inputs.end(), length, bits);
+    }
+    if (inputs.size() != ticks) return false;
+
+    hashes.resize(ticks);
+    for (size_t t = 0; t < ticks; ++t, p += 4) hashes[t] = static_cast<std::uint32_t>(getBytes(p, 4));
+    return true;
+}
+
+int runReplay(const char* path) {
+    Replay replay;
+    if (!replay.load(path)) {
+        std::fprintf(stderr, "replay: nao foi possivel ler %s\n", path);
+        return 1;
+    }
+
+    // O mesmo tickDt que o jogo usou ao gravar
+    FixedStep step;
+    step.init(replay.tickRate, 1);
+
+    JobSystem jobs;
+    jobs.init(0);
+
+    Simulation sim;
+    initSimulation(sim);
+    sim.jobs = &jobs;
+    startGame(sim, replay.seed);
+
+    long long mismatchTick = -1;
+    size_t ticks = replay.inputs.size();
+
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    for (size_t t = 0; t < ticks; ++t) {
+        stepSimulation(sim, unpackInput(replay.inputs[t]), step.tickDt);
+        if (replayHash(sim) != replay.hashes[t]) {
+            mismatchTick = static_cast<long long>(t);
+            break;
+        }
+    }
+    double totalSec = std::chrono::duration<double>(clock::now() - start).count();
+    size_t played = mismatchTick >= 0 ? static_cast<size_t>(mismatchTick) + 1 : ticks;
+
+    std::printf("replay:           %s\n", path);
+    std::printf("semente:          %llu\n", static_cast<unsigned long long>(replay.seed));
+    std::printf("tick rate:        %d\n", replay.tickRate);
+    std::printf("ticks:            %zu (%.1f s de jogo)\n", ticks, static_cast<double>(ticks) / replay.tickRate);
+    std::printf("tempo total:      %.3f s\n", totalSec);
+    std::printf("ticks/s:          %.0f\n", totalSec > 0.0 ? played / totalSec : 0.0);
+    std::printf("wave final:       %d%s\n", sim.currentWave, sim.gameOver ? " (game over)" : "");
+
+    if (mismatchTick >= 0) {
+        std::printf("FALHA: estado divergiu no tick %lld\n", mismatchTick);
+        return 1;
+    }
+    std::printf("OK: todos os %zu hashes bateram\n", ticks);
+    return 0;
+}
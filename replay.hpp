@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "simulation.hpp"
+
+// Gravação e replay de partidas. A simulação é determinística dado a semente
+// (Simulation::rng), o tick rate e as entradas de cada tick, então um replay
+// guarda só isso, mais um hash do estado por tick para conferir que a
+// reprodução seguiu exatamente a partida gravada.
+//
+// Formato do arquivo (little-endian):
+//   cabeçalho: "ZRPL", versão (u16), tick rate (u16), semente (u64),
+//              ticks (u32), trechos (u32)
+//   trechos:   entrada empacotada (u16) + repetições (u16), run-length das
+//              entradas: teclas seguradas viram um trecho só
+//   hashes:    u32 por tick (hashSimulation() dobrado em 32 bits, depois do tick)
+// Uso: ./jogo --record arquivo.rpl   (grava a última partida jogada)
+//      ./jogo --replay arquivo.rpl   (reproduz sem janela e confere os hashes)
+
+const std::uint16_t REPLAY_VERSION = 6;
+
+// Entrada de um player em 6 bits (também usada pelo co-op em rede)
+std::uint16_t packPlayerInput(const PlayerInput& p);
+PlayerInput unpackPlayerInput(std::uint16_t bits);
+
+// Entradas dos dois players num u16 (6 bits cada)
+std::uint16_t packInput(const TickInput& in);
+TickInput unpackInput(std::uint16_t bits);
+
+// hashSimulation() reduzido ao que vai no arquivo
+std::uint32_t replayHash(const Simulation& sim);
+
+struct ReplayRun {
+    std::uint16_t input;
+    std::uint16_t length;
+};
+
+// Grava uma partida em memória; save() escreve o arquivo
+struct ReplayRecorder {
+    std::uint64_t seed = 0;
+    int tickRate = DEFAULT_TICK_RATE;
+    std::vector<ReplayRun> runs;
+    std::vector<std::uint32_t> hashes;
+
+    // Começa uma gravação nova (chamar junto com startGame)
+    void begin(std::uint64_t gameSeed, int rate);
+
+    // Anota a entrada do tick e o estado depois dele
+    void record(const TickInput& in, const Simulation& sim);
+
+    size_t tickCount() const { return hashes.size(); }
+    bool save(const char* path) const;
+};
+
+// Replay carregado, com as entradas já expandidas por tick
+struct Replay {
+    std::uint64_t seed = 0;
+    int tickRate = DEFAULT_TICK_RATE;
+    std::vector<std::uint16_t> inputs;
+    std::vector<std::uint32_t> hashes;
+
+    bool load(const char* path);
+};
+
+// Reproduz o replay o mais rápido possível, reporta ticks/s e o primeiro tick
+// divergente. Retorna 0 se todos os hashes bateram.
+int runReplay(const char* path);
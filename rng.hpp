@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+// Gerador pseudoaleatório da simulação (PCG32). O estado vive dentro da
+// Simulation, então a mesma semente e as mesmas entradas reproduzem a mesma
+// partida em qualquer máquina, ao contrário de rand().
+struct Rng {
+    std::uint64_t state = 0x853c49e6748fea9bull;
+    std::uint64_t inc = 0xda3e39cb94b95bdbull;
+
+    void seed(std::uint64_t s, std::uint64_t stream = 54u) {
+        state = 0u;
+        inc = (stream << 1u) | 1u;
+        next();
+        state += s;
+        next();
+    }
+
+    std::uint32_t next() {
+        std::uint64_t old = state;
+        state = old * 6364136223846793005ull + inc;
+        std::uint32_t xorshifted = static_cast<std::uint32_t>(((old >> 18u) ^ old) >> 27u);
+        std::uint32_t rot = static_cast<std::uint32_t>(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((0u - rot) & 31u));
+    }
+
+    // Float uniforme em [0, 1)
+    float unit() { return static_cast<float>(next() >> 8) * (1.f / 16777216.f); }
+
+    // Inteiro uniforme em [0, bound), sem o viés do módulo
+    std::uint32_t below(std::uint32_t bound) {
+        std::uint32_t threshold = (0u - bound) % bound;
+        for (;;) {
+            std::uint32_t r = next();
+            if (r >= threshold) return r % bound;
+        }
+    }
+};
@@ -0,0 +1,262 @@
+#include "simd_kernels.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ZOMBOID_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// Versões escalares (também tratam as sobras das versões vetorizadas)
+
+static void moveTowardsScalar(float* x, float* y, const float* tx, const float* ty,
+                              size_t begin, size_t end, float step) {
+    for (size_t i = begin; i < end; ++i) {
+        float dx = tx[i] - x[i];
+        float dy = ty[i] - y[i];
+        float len = std::sqrt(dx * dx + dy * dy);
+        if (len > 0.f) {
+            x[i] = x[i] + (dx / len) * step;
+            y[i] = y[i] + (dy / len) * step;
+        }
+    }
+}
+
+static long firstOverlapScalar(const float* x, const float* y, const float* r, size_t begin, size_t end,
+                               float cx, float cy, float cr) {
+    for (size_t i = begin; i < end; ++i) {
+        float dx = x[i] - cx;
+        float dy = y[i] - cy;
+        float sum = r[i] + cr;
+        if (dx * dx + dy * dy < sum * sum) return static_cast<long>(i);
+    }
+    return -1;
+}
+
+static size_t markOverlapsScalar(const float* x, const float* y, const float* r, size_t begin, size_t end,
+                                 float cx, float cy, float cr, char* hit) {
+    size_t count = 0;
+    for (size_t i = begin; i < end; ++i) {
+        float dx = x[i] - cx;
+        float dy = y[i] - cy;
+        float sum = r[i] + cr;
+        char h = (dx * dx + dy * dy < sum * sum) ? 1 : 0;
+        hit[i] = h;
+        count += h;
+    }
+    return count;
+}
+
+static void moveTowardsScalarAll(float* x, float* y, const float* tx, const float* ty, size_t n, float step) {
+    moveTowardsScalar(x, y, tx, ty, 0, n, step);
+}
+
+static long firstOverlapScalarAll(const float* x, const float* y, const float* r, size_t n,
+                                  float cx, float cy, float cr) {
+    return firstOverlapScalar(x, y, r, 0, n, cx, cy, cr);
+}
+
+static size_t markOverlapsScalarAll(const float* x, const float* y, const float* r, size_t n,
+                                    float cx, float cy, float cr, char* hit) {
+    return markOverlapsScalar(x, y, r, 0, n, cx, cy, cr, hit);
+}
+
+#ifdef ZOMBOID_X86_SIMD
+// ---------------------------------------------------------------------------
+// SSE (4 floats por vez; SSE2 é garantido em x86-64)
+
+__attribute__((target("sse2")))
+static void moveTowardsSSE(float* x, float* y, const float* tx, const float* ty, size_t n, float step) {
+    const __m128 vStep = _mm_set1_ps(step);
+    const __m128 zero = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 py = _mm_loadu_ps(y + i);
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(tx + i), px);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(ty + i), py);
+        __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+        __m128 moving = _mm_cmpgt_ps(len, zero);
+        __m128 nx = _mm_add_ps(px, _mm_mul_ps(_mm_div_ps(dx, len), vStep));
+        __m128 ny = _mm_add_ps(py, _mm_mul_ps(_mm_div_ps(dy, len), vStep));
+        // Quem tem len == 0 (divisão inválida) mantém a posição
+        _mm_storeu_ps(x + i, _mm_or_ps(_mm_and_ps(moving, nx), _mm_andnot_ps(moving, px)));
+        _mm_storeu_ps(y + i, _mm_or_ps(_mm_and_ps(moving, ny), _mm_andnot_ps(moving, py)));
+    }
+    moveTowardsScalar(x, y, tx, ty, i, n, step);
+}
+
+__attribute__((target("sse2")))
+static long firstOverlapSSE(const float* x, const float* y, const float* r, size_t n,
+                            float cx, float cy, float cr) {
+    const __m128 vcx = _mm_set1_ps(cx);
+    const __m128 vcy = _mm_set1_ps(cy);
+    const __m128 vcr = _mm_set1_ps(cr);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), vcx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), vcy);
+        __m128 sum = _mm_add_ps(_mm_loadu_ps(r + i), vcr);
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        int mask = _mm_movemask_ps(_mm_cmplt_ps(d2, _mm_mul_ps(sum, sum)));
+        if (mask) return static_cast<long>(i) + __builtin_ctz(mask);
+    }
+    return firstOverlapScalar(x, y, r, i, n, cx, cy, cr);
+}
+
+__attribute__((target("sse2")))
+static size_t markOverlapsSSE(const float* x, const float* y, const float* r, size_t n,
+                              float cx, float cy, float cr, char* hit) {
+    const __m128 vcx = _mm_set1_ps(cx);
+    const __m128 vcy = _mm_set1_ps(cy);
+    const __m128 vcr = _mm_set1_ps(cr);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), vcx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), vcy);
+        __m128 sum = _mm_add_ps(_mm_loadu_ps(r + i), vcr);
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 inside = _mm_cmplt_ps(d2, _mm_mul_ps(sum, sum));
+        // Máscara (0 ou ~0 por lane) -> 0/1 -> 4 bytes gravados de uma vez
+        __m128i ones = _mm_srli_epi32(_mm_castps_si128(inside), 31);
+        __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(ones, ones), ones);
+        int packed = _mm_cvtsi128_si32(bytes);
+        std::memcpy(hit + i, &packed, 4);
+        count += __builtin_popcount(_mm_movemask_ps(inside));
+    }
+    return count + markOverlapsScalar(x, y, r, i, n, cx, cy, cr, hit);
+}
+
+// ---------------------------------------------------------------------------
+// AVX2 (8 floats por vez). Só "avx2": sem FMA, para bater com as outras versões.
+
+__attribute__((target("avx2")))
+static void moveTowardsAVX2(float* x, float* y, const float* tx, const float* ty, size_t n, float step) {
+    const __m256 vStep = _mm256_set1_ps(step);
+    const __m256 zero = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 px = _mm256_loadu_ps(x + i);
+        __m256 py = _mm256_loadu_ps(y + i);
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(tx + i), px);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ty + i), py);
+        __m256 len = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+        __m256 moving = _mm256_cmp_ps(len, zero, _CMP_GT_OQ);
+        __m256 nx = _mm256_add_ps(px, _mm256_mul_ps(_mm256_div_ps(dx, len), vStep));
+        __m256 ny = _mm256_add_ps(py, _mm256_mul_ps(_mm256_div_ps(dy, len), vStep));
+        _mm256_storeu_ps(x + i, _mm256_blendv_ps(px, nx, moving));
+        _mm256_storeu_ps(y + i, _mm256_blendv_ps(py, ny, moving));
+    }
+    moveTowardsScalar(x, y, tx, ty, i, n, step);
+}
+
+__attribute__((target("avx2")))
+static long firstOverlapAVX2(const float* x, const float* y, const float* r, size_t n,
+                             float cx, float cy, float cr) {
+    const __m256 vcx = _mm256_set1_ps(cx);
+    const __m256 vcy = _mm256_set1_ps(cy);
+    const __m256 vcr = _mm256_set1_ps(cr);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), vcx);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), vcy);
+        __m256 sum = _mm256_add_ps(_mm256_loadu_ps(r + i), vcr);
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(d2, _mm256_mul_ps(sum, sum), _CMP_LT_OQ));
+        if (mask) return static_cast<long>(i) + __builtin_ctz(mask);
+    }
+    return firstOverlapScalar(x, y, r, i, n, cx, cy, cr);
+}
+
+__attribute__((target("avx2")))
+static size_t markOverlapsAVX2(const float* x, const float* y, const float* r, size_t n,
+                               float cx, float cy, float cr, char* hit) {
+    const __m256 vcx = _mm256_set1_ps(cx);
+    const __m256 vcy = _mm256_set1_ps(cy);
+    const __m256 vcr = _mm256_set1_ps(cr);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), vcx);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), vcy);
+        __m256 sum = _mm256_add_ps(_mm256_loadu_ps(r + i), vcr);
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 inside = _mm256_cmp_ps(d2, _mm256_mul_ps(sum, sum), _CMP_LT_OQ);
+        __m256i ones = _mm256_srli_epi32(_mm256_castps_si256(inside), 31);
+        __m128i lo = _mm256_castsi256_si128(ones);
+        __m128i hi = _mm256_extracti128_si256(ones, 1);
+        __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(lo, hi), _mm_setzero_si128());
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(hit + i), bytes);
+        count += __builtin_popcount(_mm256_movemask_ps(inside));
+    }
+    return count + markOverlapsScalar(x, y, r, i, n, cx, cy, cr, hit);
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// Despacho em tempo de execução
+
+typedef void (*MoveFn)(float*, float*, const float*, const float*, size_t, float);
+typedef long (*FirstOverlapFn)(const float*, const float*, const float*, size_t, float, float, float);
+typedef size_t (*MarkOverlapsFn)(const float*, const float*, const float*, size_t, float, float, float, char*);
+
+struct KernelTable {
+    SimdLevel level;
+    MoveFn move;
+    FirstOverlapFn firstOverlap;
+    MarkOverlapsFn markOverlaps;
+};
+
+static KernelTable tableFor(SimdLevel level) {
+#ifdef ZOMBOID_X86_SIMD
+    if (level == SimdAVX2) return { SimdAVX2, moveTowardsAVX2, firstOverlapAVX2, markOverlapsAVX2 };
+    if (level == SimdSSE) return { SimdSSE, moveTowardsSSE, firstOverlapSSE, markOverlapsSSE };
+#endif
+    (void)level;
+    return { SimdScalar, moveTowardsScalarAll, firstOverlapScalarAll, markOverlapsScalarAll };
+}
+
+SimdLevel detectSimdLevel() {
+#ifdef ZOMBOID_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SimdAVX2;
+    if (__builtin_cpu_supports("sse2")) return SimdSSE;
+#endif
+    return SimdScalar;
+}
+
+static KernelTable g_kernels = tableFor(detectSimdLevel());
+
+SimdLevel activeSimdLevel() {
+    return g_kernels.level;
+}
+
+void setSimdLevel(SimdLevel level) {
+    if (level > detectSimdLevel()) level = detectSimdLevel();
+    g_kernels = tableFor(level);
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdAVX2: return "avx2";
+        case SimdSSE: return "sse";
+        default: return "escalar";
+    }
+}
+
+void moveTowardsTargets(float* x, float* y, const float* tx, const float* ty, size_t count, float step) {
+    g_kernels.move(x, y, tx, ty, count, step);
+}
+
+long firstCircleOverlap(const float* x, const float* y, const float* r, size_t count,
+                        float cx, float cy, float cr) {
+    return g_kernels.firstOverlap(x, y, r, count, cx, cy, cr);
+}
+
+size_t markCircleOverlaps(const float* x, const float* y, const float* r, size_t count,
+                          float cx, float cy, float cr, char* hit) {
+    return g_kernels.markOverlaps(x, y, r, count, cx, cy, cr, hit);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+// Kernels vetorizados sobre os arrays de ZombieStore. Cada kernel tem versão
+// escalar, SSE e AVX2; a melhor suportada pela CPU é escolhida em tempo de
+// execução. As versões fazem as mesmas operações na mesma ordem (sem FMA),
+// então dão resultados idênticos bit a bit e a simulação não muda de acordo
+// com a máquina.
+
+enum SimdLevel {
+    SimdScalar,
+    SimdSSE,
+    SimdAVX2
+};
+
+// Melhor nível suportado pela CPU atual
+SimdLevel detectSimdLevel();
+
+// Nível usado pelos kernels (começa em detectSimdLevel()); trocar serve para comparar
+SimdLevel activeSimdLevel();
+void setSimdLevel(SimdLevel level); // Limitado ao que a CPU suporta
+const char* simdLevelName(SimdLevel level);
+
+// Move cada zumbi 'step' pixels em direção a (tx[i], ty[i]); quem já está no alvo fica parado
+void moveTowardsTargets(float* x, float* y, const float* tx, const float* ty, size_t count, float step);
+
+// Índice do primeiro zumbi que encosta no círculo (cx, cy, cr), ou -1
+long firstCircleOverlap(const float* x, const float* y, const float* r, size_t count,
+                        float cx, float cy, float cr);
+
+// Marca em hit[i] (0/1) os zumbis que encostam no círculo e devolve quantos são
+size_t markCircleOverlaps(const float* x, const float* y, const float* r, size_t count,
+                          float cx, float cy, float cr, char* hit);
@@ -0,0 +1,808 @@
+#include "simulation.hpp"
+#include "simd_kernels.hpp"
+#include "profiler.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+
+// Função para verificar colisão entre dois círculos
+bool checkCircleCollision(sf::Vector2f p1, float r1, sf::Vector2f p2, float r2) {
+    float dx = p1.x - p2.x;
+    float dy = p1.y - p2.y;
+    float distanceSquared = dx * dx + dy * dy;
+    float radiusSum = r1 + r2;
+    return distanceSquared < (radiusSum * radiusSum);
+}
+
+// Função para verificar colisão entre círculo e retângulo
+bool checkCircleRectCollision(sf::Vector2f circlePos, float circleRadius,
+                              sf::Vector2f rectPos, sf::Vector2f rectSize) {
+    // A posição do shape do retângulo é o centro devido ao setOrigin
+    float halfRectW = rectSize.x / 2.0f;
+    float halfRectH = rectSize.y / 2.0f;
+
+    float rectLeft = rectPos.x - halfRectW;
+    float rectRight = rectPos.x + halfRectW;
+    float rectTop = rectPos.y - halfRectH;
+    float rectBottom = rectPos.y + halfRectH;
+
+    float testX = circlePos.x;
+    float testY = circlePos.y;
+
+    if (circlePos.x < rectLeft)         testX = rectLeft;
+    else if (circlePos.x > rectRight) testX = rectRight;
+
+    if (circlePos.y < rectTop)         testY = rectTop;
+    else if (circlePos.y > rectBottom) testY = rectBottom;
+
+    float distX = circlePos.x - testX;
+    float distY = circlePos.y - testY;
+    float distanceSquared = (distX * distX) + (distY * distY);
+
+    return distanceSquared < (circleRadius * circleRadius);
+}
+
+bool sweepCircleCircle(sf::Vector2f p0, sf::Vector2f p1, float r, sf::Vector2f center, float centerRadius, float& t) {
+    sf::Vector2f d = p1 - p0;
+    sf::Vector2f m = p0 - center;
+    float radiusSum = r + centerRadius;
+    float c = m.x * m.x + m.y * m.y - radiusSum * radiusSum;
+    if (c < 0.f) { // Já encostado no começo do caminho
+        t = 0.f;
+        return true;
+    }
+    float a = d.x * d.x + d.y * d.y;
+    float b = m.x * d.x + m.y * d.y;
+    if (a <= 0.f || b >= 0.f) return false; // Parado ou se afastando
+    float disc = b * b - a * c;
+    if (disc < 0.f) return false;
+    float hit = (-b - std::sqrt(disc)) / a;
+    if (hit > 1.f) return false;
+    t = std::max(0.f, hit);
+    return true;
+}
+
+// Primeiro t em [0, 1] em que o segmento p0 + d*t entra na caixa, pelo método das faixas
+static bool sweepPointBox(sf::Vector2f p0, sf::Vector2f d, float minX, float minY, float maxX, float maxY, float& t) {
+    const float origin[2] = { p0.x, p0.y };
+    const float dir[2] = { d.x, d.y };
+    const float lo[2] = { minX, minY };
+    const float hi[2] = { maxX, maxY };
+    float tMin = 0.f, tMax = 1.f;
+    for (int k = 0; k < 2; ++k) {
+        if (dir[k] == 0.f) {
+            if (origin[k] < lo[k] || origin[k] > hi[k]) return false;
+            continue;
+        }
+        float t0 = (lo[k] - origin[k]) / dir[k];
+        float t1 = (hi[k] - origin[k]) / dir[k];
+        if (t0 > t1) std::swap(t0, t1);
+        tMin = std::max(tMin, t0);
+        tMax = std::min(tMax, t1);
+        if (tMin > tMax) return false;
+    }
+    t = tMin;
+    return true;
+}
+
+bool sweepCircleRect(sf::Vector2f p0, sf::Vector2f p1, float r, sf::Vector2f rectPos, sf::Vector2f rectSize, float& t) {
+    if (checkCircleRectCollision(p0, r, rectPos, rectSize)) {
+        t = 0.f;
+        return true;
+    }
+    // O centro do círculo encosta no retângulo quando entra na soma de
+    // Minkowski dele com o círculo: duas caixas em cruz (o retângulo
+    // expandido por r só na horizontal e só na vertical) mais um círculo de
+    // raio r em cada canto. O primeiro contato é o menor t entre as seis.
+    sf::Vector2f d = p1 - p0;
+    float hx = rectSize.x / 2.f, hy = rectSize.y / 2.f;
+    float best = 2.f, hit;
+    if (sweepPointBox(p0, d, rectPos.x - hx - r, rectPos.y - hy, rectPos.x + hx + r, rectPos.y + hy, hit)) best = std::min(best, hit);
+    if (sweepPointBox(p0, d, rectPos.x - hx, rectPos.y - hy - r, rectPos.x + hx, rectPos.y + hy + r, hit)) best = std::min(best, hit);
+    const sf::Vector2f corners[4] = {
+        { rectPos.x - hx, rectPos.y - hy }, { rectPos.x + hx, rectPos.y - hy },
+        { rectPos.x - hx, rectPos.y + hy }, { rectPos.x + hx, rectPos.y + hy }
+    };
+    for (const sf::Vector2f& corner : corners) {
+        if (sweepCircleCircle(p0, p1, r, corner, 0.f, hit)) best = std::min(best, hit);
+    }
+    if (best > 1.f) return false;
+    t = best;
+    return true;
+}
+
+void initSimulation(Simulation& sim, const SimConfig& config) {
+    sim.config = config;
+
+    // Players
+    sim.player1.shape.setRadius(12.0f);
+    sim.player1.shape.setFillColor(sf::Color::Red);
+    sim.player1.shape.setOrigin(12.0f, 12.0f);
+
+    sim.player2.shape.setRadius(12.0f);
+    sim.player2.shape.setFillColor(sf::Color::Blue);
+    sim.player2.shape.setOrigin(12.0f, 12.0f);
+
+    // Base Central
+    sim.base.setSize(sf::Vector2f(24.f, 24.f));
+    sim.base.setFillColor(sf::Color::Yellow);
+    sim.base.setOrigin(12.f, 12.f);
+
+    sim.effects.init(AREA_EFFECT_CAPACITY);
+    sim.events.reserve(SIM_EVENT_CAPACITY);
+    sim.bullets.init(bulletPoolCapacity(config.bulletRate, BULLET_SPEED, (float)WORLD_W, (float)WORLD_H, 2));
+
+    sim.flowField.init(-GRID_MARGIN, -GRID_MARGIN, WORLD_W + GRID_MARGIN, WORLD_H + GRID_MARGIN, FLOW_CELL_SIZE);
+    sim.zombieGrid.init(-GRID_MARGIN, -GRID_MARGIN, WORLD_W + GRID_MARGIN, WORLD_H + GRID_MARGIN, GRID_CELL_SIZE);
+
+    resetGame(sim);
+}
+
+void resetGame(Simulation& sim) {
+    sim.player1.alive = true;
+    sim.player2.alive = true;
+
+    sim.player1.shape.setPosition(WORLD_W / 3.0f, WORLD_H / 2.0f);
+    sim.player2.shape.setPosition(2 * WORLD_W / 3.0f, WORLD_H / 2.0f);
+    sim.base.setPosition(WORLD_W / 2.0f, WORLD_H / 2.0f);
+    sim.player1.prevPosition = sim.player1.shape.getPosition();
+    sim.player2.prevPosition = sim.player2.shape.getPosition();
+
+    sim.player1.lastDir = {0.f, -1.f};
+    sim.player2.lastDir = {0.f, -1.f};
+    sim.player1.shootTimer = 0.f;
+    sim.player2.shootTimer = 0.f;
+    sim.player1.abilityTimer = 0.f;
+    sim.player2.abilityTimer = 0.f;
+
+    sim.zombies.clear();
+    sim.bullets.clear();
+    sim.spawnTimer = 0.f;
+
+    // Reseta variáveis do sistema de waves
+    sim.currentWave = 0;
+    sim.zombiesToSpawn = 0;
+    sim.zombiesSpawnedThisWave = 0;
+    sim.zombiesRemaining = 0;
+    sim.gameOver = false;
+    sim.zombiesKilled = 0;
+
+    sim.barricades.clear();
+    sim.barricadeVersion++;
+    sim.events.clear();
+    sim.effects.clear();
+}
+
+void startNextWave(Simulation& sim) {
+    sim.currentWave++;
+    sim.zombiesToSpawn = sim.config.initialZombies + (sim.currentWave - 1) * sim.config.zombieIncrementPerWave;
+    sim.zombiesSpawnedThisWave = 0;
+    sim.zombiesRemaining = sim.zombiesToSpawn;
+}
+
+void startGame(Simulation& sim, std::uint64_t seed) {
+    resetGame(sim);
+    sim.rng.seed(seed);
+    startNextWave(sim);
+}
+
+// Anota um evento para os efeitos visuais (descartado se o tick já encheu o vetor)
+static void emitEvent(Simulation& sim, SimEventType type, std::uint8_t owner, sf::Vector2f pos,
+                      sf::Vector2f dir, float radius = 0.f) {
+    if (sim.events.size() >= SIM_EVENT_CAPACITY) return;
+    sim.events.push_back(SimEvent{ type, owner, pos.x, pos.y, dir.x, dir.y, radius });
+}
+
+// Direção normalizada a partir das teclas de movimento
+static sf::Vector2f inputDirection(const PlayerInput& in) {
+    sf::Vector2f dir(0.f, 0.f);
+    if (in.up) dir.y -= 1.f;
+    if (in.down) dir.y += 1.f;
+    if (in.left) dir.x -= 1.f;
+    if (in.right) dir.x += 1.f;
+
+    if (dir.x != 0.f || dir.y != 0.f) {
+        float len = std::sqrt(dir.x * dir.x + dir.y * dir.y);
+        dir /= len;
+    }
+    return dir;
+}
+
+void movePlayer(Player& player, const PlayerInput& in, float dt) {
+    sf::Vector2f dir = inputDirection(in);
+    if (dir.x != 0.f || dir.y != 0.f) {
+        player.lastDir = dir;
+    }
+
+    sf::Vector2f pos = player.shape.getPosition() + dir * SPEED * dt;
+    float r = player.shape.getRadius();
+    pos.x = std::clamp(pos.x, r, (float)WORLD_W - r);
+    pos.y = std::clamp(pos.y, r, (float)WORLD_H - r);
+    player.shape.setPosition(pos);
+}
+
+// Movimento e tiro de um player
+static void updatePlayer(Simulation& sim, Player& player, BulletOwner owner, const PlayerInput& in, float dt) {
+    movePlayer(player, in, dt);
+
+    if (in.shoot && player.shootTimer * 1000.f > sim.config.bulletRate) {
+        sim.bullets.spawn(player.shape.getPosition(), player.lastDir * BULLET_SPEED, owner);
+        player.shootTimer = 0.f;
+        emitEvent(sim, EventShot, owner, player.shape.getPosition(), player.lastDir);
+    }
+}
+
+// Habilidade do Player 1 (Explosão): detona ainda neste tick, depois das balas
+static void triggerExplosion(Simulation& sim) {
+    AreaEffect ex;
+    ex.position = sim.player1.shape.getPosition();
+    ex.radius = sim.config.explosionRadius;
+    ex.chainDepth = sim.config.explosionChainDepth;
+    ex.owner = OwnerPlayer1;
+    spawnAreaEffect(sim, ex);
+    sim.player1.abilityTimer = 0.f; // Inicia o cooldown da habilidade
+}
+
+Barricade makeBarricade(sf::Vector2f position, int health) {
+    Barricade newBarricade;
+    newBarricade.shape.setSize(BARRICADE_SIZE);
+    newBarricade.shape.setFillColor(sf::Color(0, 150, 255)); // Azul padrão
+    newBarricade.shape.setOrigin(BARRICADE_SIZE.x / 2.f, BARRICADE_SIZE.y / 2.f);
+    newBarricade.shape.setPosition(position);
+    newBarricade.health = health;
+    newBarricade.maxHealth = health;
+    return newBarricade;
+}
+
+// Habilidade do Player 2 (Barricada) à frente do player
+static void placeBarricade(Simulation& sim) {
+    // Usando o raio do player + metade da largura da barricada + um pequeno espaçamento
+    float offset = sim.player2.shape.getRadius() + BARRICADE_SIZE.x / 2.f + BARRICADE_GAP;
+    sf::Vector2f barricadePos = sim.player2.shape.getPosition() + sim.player2.lastDir * offset;
+
+    sim.barricades.add(makeBarricade(barricadePos, sim.config.barrierLife));
+    sim.barricadeVersion++;
+    sim.player2.abilityTimer = 0.f; // Inicia o cooldown da habilidade
+}
+
+// Recalcula o campo de fluxo até a base com as barricadas atuais
+static void rebuildFlowField(Simulation& sim) {
+    sim.flowObstacles.clear();
+    for (const Barricade& bar : sim.barricades) {
+        sf::Vector2f pos = bar.shape.getPosition();
+        sf::Vector2f size = bar.shape.getSize();
+        sim.flowObstacles.push_back(sf::FloatRect(pos.x - size.x / 2.f, pos.y - size.y / 2.f, size.x, size.y));
+    }
+    sim.flowField.build(sim.base.getPosition(), sim.flowObstacles, ZOMBIE_RADIUS, BARRICADE_PATH_COST);
+    sim.flowField.builtVersion = sim.barricadeVersion;
+}
+
+// Roda fn(begin, end) sobre [0, count) dividido entre as threads quando há
+// zumbis suficientes, ou de uma vez na thread atual
+template <typename Fn>
+static void forEachZombieChunk(Simulation& sim, size_t count, Fn&& fn) {
+    if (sim.jobs && count >= PARALLEL_MIN_ZOMBIES) {
+        sim.jobs->parallelFor(count, PARALLEL_GRAIN, fn);
+    } else {
+        fn(0, count);
+    }
+}
+
+// Barricada que o zumbi i está tocando (a de maior índice, como no laço
+// original), ou -1
+static int findBarricadeContact(const Simulation& sim, size_t i) {
+    const ZombieStore& zs = sim.zombies;
+    for (int j = static_cast<int>(sim.barricades.size()) - 1; j >= 0; --j) {
+        const sf::RectangleShape& shape = sim.barricades[j].shape;
+        if (checkCircleRectCollision(zs.position(i), zs.radius[i], shape.getPosition(), shape.getSize())) {
+            return j;
+        }
+    }
+    return -1;
+}
+
+// Guarda as posições do fim do tick anterior, usadas para interpolar a renderização
+static void savePreviousPositions(Simulation& sim) {
+    sim.player1.prevPosition = sim.player1.shape.getPosition();
+    sim.player2.prevPosition = sim.player2.shape.getPosition();
+    sim.zombies.prevX = sim.zombies.x;
+    sim.zombies.prevY = sim.zombies.y;
+    for (Bullet& b : sim.bullets.slots) b.prevPosition = b.position;
+}
+
+// Monta a grade de colisão com as posições atuais dos zumbis
+static void buildZombieGrid(Simulation& sim) {
+    const ZombieStore& zs = sim.zombies;
+    sim.zombieGrid.build(static_cast<int>(zs.size()), [&](int i) {
+        return zs.position(i);
+    });
+    float maxZombieRadius = 0.f;
+    for (float r : zs.radius) maxZombieRadius = std::max(maxZombieRadius, r);
+    sim.zombieGridReach = maxZombieRadius;
+}
+
+bool spawnAreaEffect(Simulation& sim, const AreaEffect& effect) {
+    return sim.effects.spawn(effect);
+}
+
+// Detona o efeito 'index': consulta só as células da grade sob o retângulo
+// do efeito, marca os zumbis vivos que ele toca e cria as detonações em
+// cadeia. O custo é proporcional aos zumbis por perto, não à horda inteira.
+static int detonateAreaEffect(Simulation& sim, size_t index) {
+    sim.effects.items[index].detonated = true;
+    const AreaEffect e = sim.effects.items[index]; // Cópia: a cadeia acrescenta efeitos ao vetor
+    emitEvent(sim, EventExplosion, e.owner, e.position, e.direction, e.radius);
+
+    ZombieStore& zs = sim.zombies;
+    const float reach = e.radius + sim.zombieGridReach;
+    int kills = 0;
+    sim.zombieGrid.query(e.position.x - reach, e.position.y - reach, e.position.x + reach, e.position.y + reach, [&](int j) {
+        if (!zs.alive[j]) return;
+        sf::Vector2f zp = zs.position(j);
+        if (!checkCircleCollision(e.position, e.radius, zp, zs.radius[j])) return;
+
+        sf::Vector2f away = zp - e.position;
+        float len = std::hypot(away.x, away.y);
+        if (e.shape == AreaCone) {
+            // Ângulo até o eixo dentro da meia abertura (com folga do raio do zumbi)
+            float along = away.x * e.direction.x + away.y * e.direction.y;
+            if (along < e.coneCos * len - zs.radius[j]) return;
+        }
+
+        zs.kill(j);
+        sim.zombiesRemaining--;
+        sim.zombiesKilled++;
+        kills++;
+        emitEvent(sim, EventZombieKilled, e.owner, zp, len > 0.f ? away / len : sf::Vector2f(0.f, -1.f));
+
+        if (e.chainDepth > 0) {
+            AreaEffect chained;
+            chained.position = zp;
+            chained.radius = EXPLOSION_CHAIN_RADIUS;
+            chained.fuse = EXPLOSION_CHAIN_FUSE;
+            chained.chainDepth = e.chainDepth - 1;
+            chained.owner = e.owner;
+            spawnAreaEffect(sim, chained);
+        }
+    });
+    return kills;
+}
+
+int updateAreaEffects(Simulation& sim, float dt) {
+    AreaEffectPool& fx = sim.effects;
+
+    // Detonados expandem e desvanecem até sumir; os outros queimam o pavio
+    for (size_t i = 0; i < fx.size();) {
+        AreaEffect& e = fx.items[i];
+        if (e.detonated) {
+            e.currentRadius = std::min(e.radius, e.currentRadius + e.expandSpeed * dt);
+            e.alpha -= e.fadeSpeed * dt;
+            if (e.alpha <= 0.f) {
+                fx.removeAt(i); // O último vem para cá e é visto nesta mesma volta
+                continue;
+            }
+        } else {
+            e.fuse -= dt;
+        }
+        ++i;
+    }
+
+    // Cadeias sem pavio entram no fim do vetor e detonam nesta mesma passada
+    int kills = 0;
+    for (size_t i = 0; i < fx.size(); ++i) {
+        if (!fx.items[i].detonated && fx.items[i].fuse <= 0.f) kills += detonateAreaEffect(sim, i);
+    }
+    return kills;
+}
+
+int damageZombiesInRadius(Simulation& sim, sf::Vector2f center, float radius) {
+    buildZombieGrid(sim);
+    AreaEffect blast;
+    blast.position = center;
+    blast.radius = radius;
+    blast.owner = OwnerPlayer1;
+    if (!spawnAreaEffect(sim, blast)) return 0;
+    int kills = detonateAreaEffect(sim, sim.effects.size() - 1);
+    sim.zombies.removeDead();
+    return kills;
+}
+
+// Refaz as listas de barricadas candidatas por célula do campo de fluxo:
+// cada barricada entra nas células que o retângulo dela, expandido por
+// ZOMBIE_RADIUS, cobre (contagem, soma de prefixos e preenchimento, como a
+// SpatialGrid). Dentro de cada célula os índices ficam em ordem crescente.
+static void rebuildBarricadeCells(Simulation& sim) {
+    const FlowField& flow = sim.flowField;
+    const int cells = flow.cols * flow.rows;
+    sim.barricadeCellStart.assign(static_cast<size_t>(cells) + 1, 0);
+
+    auto forEachCell = [&](int j, auto&& fn) {
+        sf::Vector2f pos = sim.barricades[j].shape.getPosition();
+        sf::Vector2f half = sim.barricades[j].shape.getSize() / 2.f;
+        int x0 = flow.cellX(pos.x - half.x - ZOMBIE_RADIUS), x1 = flow.cellX(pos.x + half.x + ZOMBIE_RADIUS);
+        int y0 = flow.cellY(pos.y - half.y - ZOMBIE_RADIUS), y1 = flow.cellY(pos.y + half.y + ZOMBIE_RADIUS);
+        for (int cy = y0; cy <= y1; ++cy) {
+            for (int cx = x0; cx <= x1; ++cx) fn(cy * flow.cols + cx);
+        }
+    };
+
+    const int barricadeCount = static_cast<int>(sim.barricades.size());
+    for (int j = 0; j < barricadeCount; ++j) {
+        forEachCell(j, [&](int cell) { sim.barricadeCellStart[cell + 1]++; });
+    }
+    for (int c = 0; c < cells; ++c) sim.barricadeCellStart[c + 1] += sim.barricadeCellStart[c];
+    sim.barricadeCellItems.resize(static_cast<size_t>(sim.barricadeCellStart[cells]));
+    sim.barricadeCellFill.assign(sim.barricadeCellStart.begin(), sim.barricadeCellStart.end() - 1);
+    for (int j = 0; j < barricadeCount; ++j) {
+        forEachCell(j, [&](int cell) { sim.barricadeCellItems[sim.barricadeCellFill[cell]++] = j; });
+    }
+    sim.barricadeCellsVersion = sim.barricadeVersion;
+    sim.barricadeCellsBuilt = true;
+}
+
+// Barricada que o zumbi i está tocando (a de maior índice), procurando só
+// nas candidatas da célula dele; ou -1
+static int findCachedBarricadeContact(const Simulation& sim, size_t i, int cell) {
+    const ZombieStore& zs = sim.zombies;
+    if (zs.radius[i] > ZOMBIE_RADIUS) return findBarricadeContact(sim, i); // Maior que a margem das listas
+    for (int k = sim.barricadeCellStart[cell + 1] - 1; k >= sim.barricadeCellStart[cell]; --k) {
+        int j = sim.barricadeCellItems[k];
+        const sf::RectangleShape& shape = sim.barricades[j].shape;
+        if (checkCircleRectCollision(zs.position(i), zs.radius[i], shape.getPosition(), shape.getSize())) {
+            return j;
+        }
+    }
+    return -1;
+}
+
+void updateZombies(Simulation& sim, float dt) {
+    ZombieStore& zs = sim.zombies;
+    if (!sim.flowField.built || sim.flowField.builtVersion != sim.barricadeVersion) {
+        rebuildFlowField(sim);
+    }
+    if (!sim.barricadeCellsBuilt || sim.barricadeCellsVersion != sim.barricadeVersion) {
+        rebuildBarricadeCells(sim);
+    }
+
+    // Uma passada por pedaço da horda: cada zumbi ganha um alvo (o centro da
+    // base na célula da base, senão um ponto uma célula adiante na direção do
+    // campo), o kernel vetorizado avança o pedaço todo e, com o pedaço ainda
+    // no cache, cada zumbi procura a barricada que toca entre as candidatas
+    // da sua célula e testa base e players. Pedaços são independentes entre
+    // si; os efeitos ficam para resolveZombieContacts().
+    const FlowField& flow = sim.flowField;
+    const size_t zombieCount = zs.size();
+    const float step = sim.config.zombieSpeed * dt;
+    const sf::Vector2f basePos = sim.base.getPosition();
+    const float baseRadius = sim.base.getSize().x / 2.f;
+    const Player* players[2] = { &sim.player1, &sim.player2 };
+    const std::uint8_t playerHit[2] = { ZombieHitPlayer1, ZombieHitPlayer2 };
+    const bool anyBarricade = !sim.barricades.empty();
+
+    sim.moveTargetX.resize(zombieCount);
+    sim.moveTargetY.resize(zombieCount);
+    sim.barricadeContact.resize(zombieCount);
+    sim.zombieHits.resize(zombieCount);
+    forEachZombieChunk(sim, zombieCount, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            int cell = flow.cellIndex(zs.x[i], zs.y[i]);
+            if (flow.goal[cell]) {
+                sim.moveTargetX[i] = basePos.x;
+                sim.moveTargetY[i] = basePos.y;
+            } else {
+                sim.moveTargetX[i] = zs.x[i] + flow.direction[cell].x * flow.cellSize;
+                sim.moveTargetY[i] = zs.y[i] + flow.direction[cell].y * flow.cellSize;
+            }
+        }
+        moveTowardsTargets(zs.x.data() + begin, zs.y.data() + begin,
+                           sim.moveTargetX.data() + begin, sim.moveTargetY.data() + begin, end - begin, step);
+
+        for (size_t i = begin; i < end; ++i) {
+            sf::Vector2f p = zs.position(i);
+            sim.barricadeContact[i] = anyBarricade ? findCachedBarricadeContact(sim, i, flow.cellIndex(p.x, p.y)) : -1;
+
+            std::uint8_t hits = 0;
+            if (checkCircleCollision(p, zs.radius[i], basePos, baseRadius)) hits |= ZombieHitBase;
+            for (int k = 0; k < 2; ++k) {
+                if (players[k]->alive &&
+                    checkCircleCollision(p, zs.radius[i], players[k]->shape.getPosition(), players[k]->shape.getRadius())) {
+                    hits |= playerHit[k];
+                }
+            }
+            sim.zombieHits[i] = hits;
+        }
+    });
+}
+
+// Move as balas e marca os zumbis atingidos, sem compactar o armazenamento:
+// o tick ainda roda os efeitos de área sobre a mesma grade antes de removeDead()
+static void collideBullets(Simulation& sim, float dt) {
+    ZombieStore& zs = sim.zombies;
+
+    for (int i = 0; i < sim.bullets.capacity(); ++i) {
+        Bullet& b = sim.bullets.slots[i];
+        if (b.active) b.position += b.velocity * dt;
+    }
+
+    // COLISÕES
+    // Colisão contínua: cada bala varre o caminho do tick inteiro (de
+    // position - velocity * dt até position) e fica com o primeiro contato,
+    // seja zumbi ou barricada; assim nenhuma bala atravessa um zumbi de
+    // 12 px mesmo com tick baixo ou frame travado. Candidatos vêm da grade
+    // dos zumbis e das listas de barricadas por célula do campo de fluxo,
+    // sobre o retângulo que o caminho cobre. Empate entre zumbis fica com o
+    // de maior índice. As balas liberam o slot na hora; os zumbis só são
+    // marcados, porque a grade guarda os índices deles.
+    buildZombieGrid(sim);
+    const bool anyBarricade = sim.config.barricadesBlockBullets && !sim.barricades.empty();
+    if (anyBarricade && (!sim.barricadeCellsBuilt || sim.barricadeCellsVersion != sim.barricadeVersion)) {
+        rebuildBarricadeCells(sim);
+    }
+
+    const FlowField& flow = sim.flowField;
+    const float reach = BULLET_RADIUS + sim.zombieGridReach;
+    for (int i = sim.bullets.capacity() - 1; i >= 0; --i) {
+        Bullet& b = sim.bullets.slots[i];
+        if (!b.active) continue;
+        sf::Vector2f p1 = b.position;
+        sf::Vector2f p0 = p1 - b.velocity * dt;
+        float minX = std::min(p0.x, p1.x), maxX = std::max(p0.x, p1.x);
+        float minY = std::min(p0.y, p1.y), maxY = std::max(p0.y, p1.y);
+
+        float firstT = 2.f;
+        int hitZombie = -1;
+        sim.zombieGrid.query(minX - reach, minY - reach, maxX + reach, maxY + reach, [&](int j) {
+            float t;
+            if (zs.alive[j] && sweepCircleCircle(p0, p1, BULLET_RADIUS, zs.position(j), zs.radius[j], t) &&
+                (t < firstT || (t == firstT && j > hitZombie))) {
+                firstT = t;
+                hitZombie = j;
+            }
+        });
+
+        // As listas por célula já incluem ZOMBIE_RADIUS (maior que BULLET_RADIUS)
+        // de margem, então basta olhar as células que o centro da bala cruza
+        // Barricada junto da boca do cano (até BARRICADE_COVER_MARGIN de onde a
+        // bala saiu) não segura o tiro, esteja o atirador onde estiver agora
+        bool hitBarricade = false;
+        if (anyBarricade) {
+            int x0 = flow.cellX(minX), x1 = flow.cellX(maxX);
+            int y0 = flow.cellY(minY), y1 = flow.cellY(maxY);
+            for (int cy = y0; cy <= y1; ++cy) {
+                for (int cx = x0; cx <= x1; ++cx) {
+                    int cell = cy * flow.cols + cx;
+                    for (int k = sim.barricadeCellStart[cell]; k < sim.barricadeCellStart[cell + 1]; ++k) {
+                        const sf::RectangleShape& shape = sim.barricades[sim.barricadeCellItems[k]].shape;
+                        sf::Vector2f half = shape.getSize() / 2.f;
+                        sf::Vector2f center = shape.getPosition();
+                        if (std::abs(b.origin.x - center.x) <= half.x + BARRICADE_COVER_MARGIN &&
+                            std::abs(b.origin.y - center.y) <= half.y + BARRICADE_COVER_MARGIN) continue;
+                        float t;
+                        if (sweepCircleRect(p0, p1, BULLET_RADIUS, shape.getPosition(), shape.getSize(), t) && t < firstT) {
+                            firstT = t;
+                            hitBarricade = true;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (hitBarricade) {
+            sim.bullets.release(i); // A barricada segura a bala (sem dano)
+        } else if (hitZombie >= 0) {
+            emitEvent(sim, EventZombieKilled, b.owner, zs.position(hitZombie), b.velocity / BULLET_SPEED);
+            zs.kill(hitZombie);
+            sim.bullets.release(i);
+            sim.zombiesRemaining--;
+            sim.zombiesKilled++;
+        }
+    }
+
+    // Libera as balas que saíram do mundo (depois da varredura, que ainda
+    // pode acertar algo no caminho até a borda)
+    const float cullMinX = -BULLET_CULL_MARGIN, cullMaxX = WORLD_W + BULLET_CULL_MARGIN;
+    const float cullMinY = -BULLET_CULL_MARGIN, cullMaxY = WORLD_H + BULLET_CULL_MARGIN;
+    for (int i = 0; i < sim.bullets.capacity(); ++i) {
+        const Bullet& b = sim.bullets.slots[i];
+        if (!b.active) continue;
+        if (b.position.y < cullMinY || b.position.y > cullMaxY || b.position.x < cullMinX || b.position.x > cullMaxX) {
+            sim.bullets.release(i);
+        }
+    }
+}
+
+void updateBullets(Simulation& sim, float dt) {
+    collideBullets(sim, dt);
+    sim.zombies.removeDead();
+}
+
+void resolveZombieContacts(Simulation& sim, float dt) {
+    ZombieStore& zs = sim.zombies;
+
+    // Dano e empurrão das barricadas em série, na ordem de sempre (zumbis do
+    // último para o primeiro), então o resultado não depende do número de
+    // threads. Zumbis mortos neste tick (balas, efeitos) não contam. Se uma
+    // barricada cai, as listas por célula são refeitas na hora e os zumbis
+    // restantes voltam a procurar nelas.
+    const size_t zombieCount = sim.barricadeContact.size();
+    bool contactsStale = false;
+    bool touchedBase = false;
+    bool touchedPlayer[2] = { false, false };
+    for (int i = static_cast<int>(zombieCount) - 1; i >= 0; --i) {
+        if (!zs.alive[i]) continue;
+
+        std::uint8_t hits = sim.zombieHits[i];
+        touchedBase = touchedBase || (hits & ZombieHitBase) != 0;
+        touchedPlayer[0] = touchedPlayer[0] || (hits & ZombieHitPlayer1) != 0;
+        touchedPlayer[1] = touchedPlayer[1] || (hits & ZombieHitPlayer2) != 0;
+
+        if (sim.barricades.empty()) continue;
+        int j = sim.barricadeContact[i];
+        if (contactsStale) {
+            if (sim.barricadeCellsVersion != sim.barricadeVersion) rebuildBarricadeCells(sim);
+            j = findCachedBarricadeContact(sim, i, sim.flowField.cellIndex(zs.x[i], zs.y[i]));
+        }
+        if (j < 0) continue;
+
+        sf::Vector2f barPos = sim.barricades[j].shape.getPosition();
+        sim.barricades[j].health--; // Barricada perde vida
+
+        // Empurra o zumbi para trás (oposto à direção da barricada para o zumbi)
+        float pushX = zs.x[i] - barPos.x;
+        float pushY = zs.y[i] - barPos.y;
+        float len = std::hypot(pushX, pushY);
+        if (len > 0) {
+            pushX /= len;
+            pushY /= len;
+        }
+        zs.x[i] += pushX * sim.config.zombieSpeed * dt * 2.0f; // Empurra com força
+        zs.y[i] += pushY * sim.config.zombieSpeed * dt * 2.0f;
+
+        // Remove a barricada se a vida acabar (O(1); a última barricada ocupa o lugar dela)
+        if (sim.barricades[j].health <= 0) {
+            sim.barricades.removeAt(j);
+            sim.barricadeVersion++;
+            contactsStale = true;
+        }
+    }
+
+    // Zumbi na base (GAME OVER) ou encostado num player
+    if (touchedBase) {
+        sim.gameOver = true;
+        sim.zombiesRemaining--;
+    }
+    if (!sim.gameOver) {
+        if (touchedPlayer[0]) sim.player1.alive = false;
+        if (touchedPlayer[1]) sim.player2.alive = false;
+    }
+}
+
+// FNV-1a sobre os bytes dados
+static void hashBytes(std::uint64_t& h, const void* data, size_t bytes) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < bytes; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+}
+
+template <typename T>
+static void hashValue(std::uint64_t& h, const T& value) {
+    hashBytes(h, &value, sizeof(value));
+}
+
+std::uint64_t hashSimulation(const Simulation& sim) {
+    std::uint64_t h = 1469598103934665603ull;
+    for (const Player* p : { &sim.player1, &sim.player2 }) {
+        sf::Vector2f pos = p->shape.getPosition();
+        hashValue(h, pos.x);
+        hashValue(h, pos.y);
+        hashValue(h, p->alive);
+        hashValue(h, p->shootTimer);
+        hashValue(h, p->abilityTimer);
+    }
+
+    const ZombieStore& zs = sim.zombies;
+    hashBytes(h, zs.x.data(), zs.size() * sizeof(float));
+    hashBytes(h, zs.y.data(), zs.size() * sizeof(float));
+
+    for (const Bullet& b : sim.bullets.slots) {
+        if (!b.active) continue;
+        hashValue(h, b.position.x);
+        hashValue(h, b.position.y);
+    }
+    for (const Barricade& bar : sim.barricades) {
+        hashValue(h, bar.shape.getPosition().x);
+        hashValue(h, bar.shape.getPosition().y);
+        hashValue(h, bar.health);
+    }
+
+    for (const AreaEffect& e : sim.effects.items) {
+        hashValue(h, e.position.x);
+        hashValue(h, e.position.y);
+        hashValue(h, e.currentRadius);
+        hashValue(h, e.fuse);
+        hashValue(h, e.detonated);
+        hashValue(h, e.chainDepth);
+    }
+
+    hashValue(h, sim.currentWave);
+    hashValue(h, sim.zombiesToSpawn);
+    hashValue(h, sim.zombiesSpawnedThisWave);
+    hashValue(h, sim.zombiesRemaining);
+    hashValue(h, sim.spawnTimer);
+    hashValue(h, sim.gameOver);
+    hashValue(h, sim.rng.state);
+    return h;
+}
+
+void stepSimulation(Simulation& sim, const TickInput& input, float dt) {
+    if (sim.gameOver) return;
+
+    ProfileLap lap; // Tempo de cada fase do tick (ver profiler.hpp)
+    savePreviousPositions(sim);
+    sim.events.clear();
+
+    sim.spawnTimer += dt;
+    sim.player1.shootTimer += dt;
+    sim.player2.shootTimer += dt;
+    sim.player1.abilityTimer += dt;
+    sim.player2.abilityTimer += dt;
+
+    // Habilidades (disparadas pelo pulso de entrada do tick)
+    if (sim.player1.alive && input.p1.ability && sim.player1.abilityTimer >= PLAYER1_ABILITY_COOLDOWN) {
+        triggerExplosion(sim);
+    }
+    if (sim.player2.alive && input.p2.ability && sim.player2.abilityTimer >= PLAYER2_ABILITY_COOLDOWN) {
+        placeBarricade(sim);
+    }
+
+    lap.mark(PhaseAbilities);
+
+    // Lógica de Spawn de Zumbis
+    ZombieStore& zs = sim.zombies;
+    if (sim.zombiesSpawnedThisWave < sim.zombiesToSpawn) {
+        if (sim.spawnTimer > sim.config.zombieSpawnTime) {
+            int side = static_cast<int>(sim.rng.below(4));
+            float spawnX = 0, spawnY = 0;
+            float spawnMargin = 60.f;
+
+            switch (side) {
+                case 0: spawnX = static_cast<float>(sim.rng.below(WORLD_W)); spawnY = -spawnMargin; break;
+                case 1: spawnX = static_cast<float>(sim.rng.below(WORLD_W)); spawnY = static_cast<float>(WORLD_H) + spawnMargin; break;
+                case 2: spawnX = -spawnMargin; spawnY = static_cast<float>(sim.rng.below(WORLD_H)); break;
+                case 3: spawnX = static_cast<float>(WORLD_W) + spawnMargin; spawnY = static_cast<float>(sim.rng.below(WORLD_H)); break;
+            }
+            zs.push(spawnX, spawnY, ZOMBIE_RADIUS);
+            sim.spawnTimer = 0.f;
+            sim.zombiesSpawnedThisWave++;
+        }
+    } else {
+        if (zs.empty() && sim.zombiesRemaining <= 0) {
+            startNextWave(sim);
+        }
+    }
+
+    lap.mark(PhaseSpawn);
+
+    // Player 1 (WASD / F) e Player 2 (setas / Numpad0)
+    if (sim.player1.alive) updatePlayer(sim, sim.player1, OwnerPlayer1, input.p1, dt);
+    if (sim.player2.alive) updatePlayer(sim, sim.player2, OwnerPlayer2, input.p2, dt);
+
+    // Movimento, contato com barricadas, base e players numa passada só
+    updateZombies(sim, dt);
+    lap.mark(PhaseMovement);
+
+    // Balas e efeitos de área usam a mesma grade; só marcam os mortos
+    collideBullets(sim, dt);
+    updateAreaEffects(sim, dt);
+    lap.mark(PhaseBulletCollision);
+
+    // Efeitos dos contatos da passada fundida (só zumbis vivos) e, por fim,
+    // a remoção de todos os mortos do tick de uma vez
+    resolveZombieContacts(sim, dt);
+    zs.removeDead();
+    lap.mark(PhaseBarricadeCollision);
+}
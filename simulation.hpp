@@ -0,0 +1,521 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "entity_pool.hpp"
+#include "flow_field.hpp"
+#include "job_system.hpp"
+#include "rng.hpp"
+#include "spatial_grid.hpp"
+
+// Núcleo da simulação: todo o estado do jogo (players, zumbis, balas, barricadas,
+// explosão e waves) vive aqui e é avançado por stepSimulation() a partir de
+// entradas por tick. Nada aqui depende de janela, teclado ou sf::Clock, então
+// a mesma lógica roda com ou sem display (ver headless.hpp).
+
+// Configurações do Mundo
+const unsigned int WORLD_W = 1600;
+const unsigned int WORLD_H = 1200;
+
+// Constantes do Jogo
+const float SPEED = 300.0f;
+const float BULLET_SPEED = 600.0f;
+const float ZOMBIE_SPEED = 60.0f;
+const float ZOMBIE_SPAWN_TIME = 0.5f;
+const float BULLET_RADIUS = 5.f;
+const float BULLET_RATE = 200; // em milissegundos
+
+// Cooldowns das Habilidades (em segundos)
+const float PLAYER1_ABILITY_COOLDOWN = 10.0f;
+const float PLAYER2_ABILITY_COOLDOWN = 10.0f;
+
+// Constantes de Habilidade
+const int BARRIER_LIFE = 500; // Vida inicial da barricada
+const sf::Vector2f BARRICADE_SIZE = {40.f, 40.f}; // Tamanho da barricada (quadrado)
+const float BARRICADE_GAP = 5.f; // Vão entre o P2 e a barricada que ele coloca
+// Bala disparada a até esta distância (em x e em y) da borda de uma barricada
+// passa por ela: o player atira por cima da própria cobertura. Cobre o player
+// encostado em qualquer lado (diâmetro de 24 px mais o vão de placeBarricade).
+const float BARRICADE_COVER_MARGIN = 24.f + BARRICADE_GAP;
+const float EXPLOSION_RADIUS = 150.f; // Raio máximo da explosão
+const float EXPLOSION_EXPAND_SPEED = 500.f; // Velocidade de expansão da explosão
+const float EXPLOSION_FADE_SPEED = 200.f; // Velocidade de desvanecimento da explosão
+const float EXPLOSION_CHAIN_RADIUS = 48.f; // Raio das detonações em cadeia (zumbis mortos por uma explosão com cadeia)
+const float EXPLOSION_CHAIN_FUSE = 0.1f;   // Segundos entre uma detonação e as que ela dispara
+const int EXPLOSION_CHAIN_DEPTH = 0;       // Gerações de detonações em cadeia da explosão do P1 (0 = sem cadeia)
+
+// Constantes das waves
+const int INITIAL_ZOMBIES = 10;
+const int ZOMBIE_INCREMENT_PER_WAVE = 5;
+
+// Parâmetros de balanceamento ajustáveis em tempo de execução, com as
+// constantes acima como valores padrão (o modo --sweep varia estes campos)
+struct SimConfig {
+    float zombieSpeed = ZOMBIE_SPEED;
+    float zombieSpawnTime = ZOMBIE_SPAWN_TIME;
+    float bulletRate = BULLET_RATE; // em milissegundos
+    int barrierLife = BARRIER_LIFE;
+    float explosionRadius = EXPLOSION_RADIUS;
+    int initialZombies = INITIAL_ZOMBIES;
+    int zombieIncrementPerWave = ZOMBIE_INCREMENT_PER_WAVE;
+    int explosionChainDepth = EXPLOSION_CHAIN_DEPTH;
+    bool barricadesBlockBullets = true; // Barricadas seguram as balas (menos as de quem está colado nelas)
+};
+
+// Grade de colisão: cobre o mundo mais uma margem (zumbis nascem 60 px fora e balas somem 100 px fora)
+const float GRID_CELL_SIZE = 64.f;
+const float GRID_MARGIN = 128.f;
+
+// Campo de fluxo dos zumbis: tamanho da célula e quanto custa atravessar uma barricada
+const float FLOW_CELL_SIZE = 20.f;
+const float BARRICADE_PATH_COST = 12.f;
+
+// Balas somem quando passam desta distância além da borda do mundo
+const float BULLET_CULL_MARGIN = 100.f;
+
+// Ticks por segundo da simulação e quantos ticks um frame lento pode recuperar
+const int DEFAULT_TICK_RATE = 60;
+const int MAX_CATCHUP_TICKS = 5;
+
+// Laços por zumbi só são divididos entre threads a partir deste tamanho (abaixo
+// disso o custo de acordar os workers passa do ganho), em pedaços deste tamanho
+const size_t PARALLEL_MIN_ZOMBIES = 4096;
+const size_t PARALLEL_GRAIN = 1024;
+
+// Dono de uma bala (para a cor na renderização)
+enum BulletOwner : std::uint8_t {
+    OwnerPlayer1 = 1,
+    OwnerPlayer2 = 2
+};
+
+// Estrutura da Bala: só o que a simulação precisa (o raio é BULLET_RADIUS)
+struct Bullet {
+    sf::Vector2f position;
+    sf::Vector2f prevPosition; // Posição no fim do tick anterior (para interpolar)
+    sf::Vector2f velocity;
+    sf::Vector2f origin; // Onde foi disparada (decide as barricadas que ela atravessa)
+    std::uint8_t owner = 0;
+    bool active = false;
+};
+
+// Quantas balas podem estar vivas ao mesmo tempo. Uma bala nasce dentro do
+// mundo e some ao passar da margem, então voa no máximo (W + H + 4 * margem)
+// pixels (cota de Manhattan para a diagonal). Cada player atira no máximo uma
+// vez a cada 'rateMs', então tem até voo / intervalo + 1 balas no ar.
+inline int bulletPoolCapacity(float rateMs, float speed, float worldW, float worldH, int players) {
+    float maxFlight = worldW + worldH + 4.f * BULLET_CULL_MARGIN;
+    float lifetimeMs = maxFlight / speed * 1000.f;
+    int perPlayer = static_cast<int>(std::ceil(lifetimeMs / rateMs)) + 1;
+    return perPlayer * players;
+}
+
+// Pool de balas de capacidade fixa, alocado uma vez em init(). Os slots são
+// reciclados em anel: o próximo tiro usa o slot depois do último usado. Com a
+// capacidade de bulletPoolCapacity() o slot da vez já está sempre livre (a
+// bala que estava nele foi disparada há mais tempo do que uma bala dura); se
+// não estiver, procura outro livre e, no pior caso, recicla o mais antigo e
+// conta em 'overflows'. Atirar nunca toca no heap.
+struct BulletPool {
+    std::vector<Bullet> slots;
+    int head = 0;      // Próximo slot do anel
+    int count = 0;     // Balas ativas
+    int overflows = 0; // Tiros que encontraram o anel cheio
+
+    void init(int capacity) {
+        slots.assign(capacity, Bullet());
+        head = 0;
+        count = 0;
+        overflows = 0;
+    }
+
+    int capacity() const { return static_cast<int>(slots.size()); }
+    int size() const { return count; }
+
+    void spawn(sf::Vector2f position, sf::Vector2f velocity, std::uint8_t owner) {
+        int cap = capacity();
+        int slot = head;
+        if (slots[slot].active) {
+            // Anel cheio no slot da vez: procura outro livre, senão recicla este
+            for (int k = 1; k < cap; ++k) {
+                int s = (head + k) % cap;
+                if (!slots[s].active) {
+                    slot = s;
+                    break;
+                }
+            }
+            if (slots[slot].active) {
+                overflows++;
+                count--;
+            }
+        }
+        Bullet& b = slots[slot];
+        b.position = position;
+        b.prevPosition = position;
+        b.velocity = velocity;
+        b.origin = position;
+        b.owner = owner;
+        b.active = true;
+        count++;
+        head = (slot + 1) % cap;
+    }
+
+    void release(int slot) {
+        if (!slots[slot].active) return;
+        slots[slot].active = false;
+        count--;
+    }
+
+    void clear() {
+        for (auto& b : slots) b.active = false;
+        head = 0;
+        count = 0;
+    }
+};
+
+// Raio de colisão dos zumbis (sprite de 64 px desenhado com 24 px)
+const float ZOMBIE_RADIUS = 12.f;
+
+// Zumbis em arrays paralelos (structure-of-arrays): os laços de movimento e
+// colisão percorrem floats contíguos. O sprite é montado só na renderização.
+// kill() é O(1): só marca o zumbi e anota o índice, para que os índices
+// continuem válidos até o fim da passada (a grade de colisão guarda índices).
+// removeDead() tira os marcados com swap-and-pop, sem deslocar os vivos.
+struct ZombieStore {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> prevX; // Posição no fim do tick anterior (para interpolar)
+    std::vector<float> prevY;
+    std::vector<float> radius;
+    std::vector<std::uint32_t> id; // Número de série do spawn: acompanha o zumbi no swap-and-pop (a rede o identifica por ele)
+    std::vector<char> alive;
+    std::vector<int> dead; // Índices marcados por kill() e ainda não removidos
+    std::uint32_t nextId = 1; // Próximo número de série (não volta ao limpar, para não repetir ids entre partidas)
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+
+    sf::Vector2f position(size_t i) const { return sf::Vector2f(x[i], y[i]); }
+
+    void push(float px, float py, float r) {
+        x.push_back(px);
+        y.push_back(py);
+        prevX.push_back(px);
+        prevY.push_back(py);
+        radius.push_back(r);
+        id.push_back(nextId++);
+        alive.push_back(1);
+    }
+
+    void clear() {
+        x.clear();
+        y.clear();
+        prevX.clear();
+        prevY.clear();
+        radius.clear();
+        id.clear();
+        alive.clear();
+        dead.clear();
+    }
+
+    // Marca o zumbi como morto; devolve false se ele já estava morto
+    bool kill(size_t i) {
+        if (!alive[i]) return false;
+        alive[i] = 0;
+        dead.push_back(static_cast<int>(i));
+        return true;
+    }
+
+    // Remove os zumbis marcados. Do maior índice para o menor, o último
+    // elemento trocado para o buraco é sempre um zumbi vivo.
+    void removeDead() {
+        if (dead.empty()) return;
+        std::sort(dead.begin(), dead.end(), std::greater<int>());
+        for (int i : dead) {
+            size_t last = x.size() - 1;
+            x[i] = x[last];
+            y[i] = y[last];
+            prevX[i] = prevX[last];
+            prevY[i] = prevY[last];
+            radius[i] = radius[last];
+            id[i] = id[last];
+            alive[i] = alive[last];
+            x.pop_back();
+            y.pop_back();
+            prevX.pop_back();
+            prevY.pop_back();
+            radius.pop_back();
+            id.pop_back();
+            alive.pop_back();
+        }
+        dead.clear();
+    }
+};
+
+// Estrutura da Barricada (para Player 2)
+struct Barricade {
+    sf::RectangleShape shape;
+    int health;
+    int maxHealth; // Para exibir x/y vida
+};
+
+// Forma de um efeito de área
+enum AreaShape : std::uint8_t {
+    AreaCircle, // Disco de raio 'radius'
+    AreaCone    // Setor de raio 'radius' em volta de 'direction'
+};
+
+// Efeito de área (explosão do P1, cones, detonações em cadeia). Espera
+// 'fuse' segundos, detona uma vez (o dano todo acontece aí) e depois só
+// expande e desvanece para ser desenhado. Com 'chainDepth' > 0, cada zumbi
+// que ele mata detona um efeito de EXPLOSION_CHAIN_RADIUS no lugar, com um
+// nível a menos.
+struct AreaEffect {
+    sf::Vector2f position;
+    sf::Vector2f direction = {1.f, 0.f}; // Eixo do cone (normalizado)
+    float coneCos = -1.f;                // Cosseno da meia abertura do cone
+    float radius = 0.f;                  // Raio do dano
+    float currentRadius = 0.f;           // Raio desenhado; expande até 'radius' depois da detonação
+    float expandSpeed = EXPLOSION_EXPAND_SPEED;
+    float fadeSpeed = EXPLOSION_FADE_SPEED;
+    float alpha = 255.f; // Guardado em float para o fade não depender do frame rate
+    float fuse = 0.f;    // Segundos até detonar
+    int chainDepth = 0;
+    AreaShape shape = AreaCircle;
+    std::uint8_t owner = 0; // BulletOwner de quem causou
+    bool detonated = false;
+};
+
+// Efeitos simultâneos guardados no máximo; os que passarem disso não são criados
+const size_t AREA_EFFECT_CAPACITY = 4096;
+
+// Efeitos de área ativos, em vetor denso (remoção por swap-and-pop). A
+// capacidade é reservada em init(), então criar efeitos não toca no heap.
+struct AreaEffectPool {
+    std::vector<AreaEffect> items;
+    size_t capacity = 0;
+    int overflows = 0; // Efeitos descartados com o pool cheio
+
+    void init(size_t cap) {
+        capacity = cap;
+        items.clear();
+        items.reserve(cap);
+        overflows = 0;
+    }
+
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+
+    bool spawn(const AreaEffect& effect) {
+        if (items.size() >= capacity) {
+            overflows++;
+            return false;
+        }
+        items.push_back(effect);
+        return true;
+    }
+
+    void removeAt(size_t i) {
+        items[i] = items.back();
+        items.pop_back();
+    }
+
+    void clear() { items.clear(); }
+};
+
+// Estado de um player
+struct Player {
+    sf::CircleShape shape;
+    sf::Vector2f prevPosition;          // Posição no fim do tick anterior (para interpolar)
+    sf::Vector2f lastDir = {0.f, -1.f}; // Última direção (mira)
+    bool alive = true;
+    float shootTimer = 0.f;   // Segundos desde o último tiro
+    float abilityTimer = 0.f; // Segundos desde o último uso da habilidade
+};
+
+// Entrada de um player em um tick. 'ability' é um pulso: vale só no tick em que a tecla foi apertada.
+struct PlayerInput {
+    bool up = false;
+    bool down = false;
+    bool left = false;
+    bool right = false;
+    bool shoot = false;
+    bool ability = false;
+};
+
+// Entradas dos dois players para um tick da simulação
+struct TickInput {
+    PlayerInput p1;
+    PlayerInput p2;
+};
+
+// Acontecimentos de um tick que interessam só aos efeitos visuais
+// (partículas). Não fazem parte do estado: não entram no hash, no snapshot
+// nem na rede.
+enum SimEventType : std::uint8_t {
+    EventShot,         // Tiro: posição da bala e direção
+    EventZombieKilled, // Zumbi morto: posição e direção do golpe (da bala, ou do centro da explosão)
+    EventExplosion     // Explosão: centro e raio
+};
+
+struct SimEvent {
+    SimEventType type;
+    std::uint8_t owner; // Player que causou (BulletOwner)
+    float x;
+    float y;
+    float dirX;
+    float dirY;
+    float radius;
+};
+
+// Eventos guardados por tick; os que passarem disso são descartados (os
+// efeitos são só visuais e o vetor nunca realoca durante o jogo)
+const size_t SIM_EVENT_CAPACITY = 4096;
+
+// O que um zumbi tocou na passada fundida (Simulation::zombieHits)
+enum ZombieHit : std::uint8_t {
+    ZombieHitBase = 1,
+    ZombieHitPlayer1 = 2,
+    ZombieHitPlayer2 = 4
+};
+
+// Estado completo da simulação
+struct Simulation {
+    SimConfig config; // Definido em initSimulation()
+
+    Player player1;
+    Player player2;
+    sf::RectangleShape base;
+
+    ZombieStore zombies;
+    BulletPool bullets;
+    EntityPool<Barricade> barricades; // Remoção O(1) por swap-and-pop (a ordem muda)
+    unsigned barricadeVersion = 0;    // Muda sempre que uma barricada é colocada ou destruída
+    AreaEffectPool effects; // Explosões e outros efeitos de área, quantos houver ao mesmo tempo
+
+    // Estado da wave
+    int currentWave = 0;
+    int zombiesToSpawn = 0;
+    int zombiesSpawnedThisWave = 0;
+    int zombiesRemaining = 0;
+    float spawnTimer = 0.f; // Segundos desde o último spawn
+
+    bool gameOver = false; // Um zumbi alcançou a base
+    int zombiesKilled = 0; // Zumbis mortos por balas e explosões na partida
+
+    Rng rng; // Sorteios da simulação (lado e posição dos spawns); semeado por quem cria a partida
+
+    // Eventos do último tick (limpos no começo de cada tick), para quem desenha
+    std::vector<SimEvent> events;
+
+    // Navegação da horda até a base, recalculada quando barricadeVersion muda
+    FlowField flowField;
+    std::vector<sf::FloatRect> flowObstacles;
+
+    // Broadphase dos zumbis, reconstruída a cada tick (buffers reaproveitados entre ticks)
+    SpatialGrid zombieGrid;
+
+    float zombieGridReach = 0.f; // Maior raio de zumbi na última montagem da grade
+
+    // Buffers de trabalho do kernel SIMD de movimento (alvos de cada zumbi)
+    std::vector<float> moveTargetX;
+    std::vector<float> moveTargetY;
+
+    // Barricadas candidatas por célula do campo de fluxo (as que um zumbi
+    // naquela célula pode tocar), refeitas só quando barricadeVersion muda:
+    // índices de barricadeCellItems em [start[c], start[c + 1])
+    std::vector<int> barricadeCellStart;
+    std::vector<int> barricadeCellItems;
+    std::vector<int> barricadeCellFill; // Cursor de preenchimento por célula (só durante a montagem)
+    unsigned barricadeCellsVersion = 0;
+    bool barricadeCellsBuilt = false;
+
+    // Resultado da passada fundida por zumbi: barricada tocada (índice ou -1)
+    // e bits ZombieHit* de base e players, calculados em paralelo
+    std::vector<int> barricadeContact;
+    std::vector<std::uint8_t> zombieHits;
+
+    // Threads para os laços por zumbi; nullptr roda tudo na thread que chama
+    JobSystem* jobs = nullptr;
+};
+
+// Função para verificar colisão entre dois círculos
+bool checkCircleCollision(sf::Vector2f p1, float r1, sf::Vector2f p2, float r2);
+
+// Função para verificar colisão entre círculo e retângulo
+bool checkCircleRectCollision(sf::Vector2f circlePos, float circleRadius,
+                              sf::Vector2f rectPos, sf::Vector2f rectSize);
+
+// Colisão contínua: um círculo de raio 'r' indo de p0 a p1 no tick. Se ele
+// encosta no alvo em algum ponto do caminho, devolve true e o primeiro
+// instante do contato em 't' (0 = p0, 1 = p1); 0 se já começa encostado.
+bool sweepCircleCircle(sf::Vector2f p0, sf::Vector2f p1, float r, sf::Vector2f center, float centerRadius, float& t);
+bool sweepCircleRect(sf::Vector2f p0, sf::Vector2f p1, float r, sf::Vector2f rectPos, sf::Vector2f rectSize, float& t);
+
+// Monta players, base e explosão com os parâmetros de 'config' (chamar uma vez
+// antes de usar a simulação)
+void initSimulation(Simulation& sim, const SimConfig& config = SimConfig());
+
+// Função para reiniciar o jogo (players, zumbis, balas, barricadas, waves e cooldowns)
+void resetGame(Simulation& sim);
+
+// Barricada nova com vida cheia ('health') centrada em 'position' (quem
+// adiciona ao pool deve incrementar barricadeVersion)
+Barricade makeBarricade(sf::Vector2f position, int health = BARRIER_LIFE);
+
+// Função para iniciar a próxima wave
+void startNextWave(Simulation& sim);
+
+// Começa uma partida do zero com a semente 'seed' (resetGame + primeira wave).
+// Mesma semente e mesmas entradas por tick reproduzem a mesma partida.
+void startGame(Simulation& sim, std::uint64_t seed);
+
+// Move o player pelas teclas de movimento, preso ao mundo (a parte do tick do
+// player que não depende do resto do mundo; o cliente de rede usa para prever
+// o próprio player)
+void movePlayer(Player& player, const PlayerInput& in, float dt);
+
+// Fases do tick, chamadas por stepSimulation() nesta ordem (expostas para
+// serem medidas isoladamente em bench.cpp)
+
+// Mata os zumbis que encostam no círculo; devolve quantos morreram. Monta a
+// grade dos zumbis e detona um efeito instantâneo sem cadeia (o mesmo
+// caminho de updateAreaEffects(), para medir isolado).
+int damageZombiesInRadius(Simulation& sim, sf::Vector2f center, float radius);
+
+// Cria um efeito de área; devolve false se o pool estava cheio
+bool spawnAreaEffect(Simulation& sim, const AreaEffect& effect);
+
+// Avança os efeitos (pavio, expansão, fade) e detona os que chegaram a zero,
+// incluindo as cadeias que detonam no mesmo tick. Usa a grade de zumbis
+// montada pela colisão das balas neste tick e só marca os mortos (quem chama
+// remove todos de uma vez com ZombieStore::removeDead()).
+int updateAreaEffects(Simulation& sim, float dt);
+
+// Passada fundida pela horda: move pelo campo de fluxo (recalculado se as
+// barricadas mudaram) e, no mesmo pedaço, guarda a barricada que cada zumbi
+// toca (em barricadeContact) e se ele toca a base ou um player (em
+// zombieHits). Nada é aplicado aqui; ver resolveZombieContacts().
+void updateZombies(Simulation& sim, float dt);
+
+// Move as balas, resolve o primeiro acerto no caminho de cada uma (zumbi ou
+// barricada, que segura a bala) e libera as que saíram do mundo
+void updateBullets(Simulation& sim, float dt);
+
+// Aplica os contatos de updateZombies() aos zumbis ainda vivos: dano e
+// empurrão nas barricadas, game over na base e morte dos players. Não
+// remove os mortos (quem chama usa ZombieStore::removeDead()).
+void resolveZombieContacts(Simulation& sim, float dt);
+
+// Hash do estado do mundo (players, zumbis, balas, barricadas, waves e
+// gerador), usado para confirmar que um replay segue a partida gravada
+std::uint64_t hashSimulation(const Simulation& sim);
+
+// Avança a simulação um tick de 'dt' segundos com as entradas dadas. O jogo
+// chama sempre com o mesmo dt (ver fixed_step.hpp), para o resultado não
+// depender do frame rate.
+void stepSimulation(Simulation& sim, const TickInput& input, float dt);
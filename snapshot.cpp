@@ -0,0 +1,457 @@
+#include "snapshot.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const std::uint16_t SNAPSHOT_BYTE_ORDER = 0x0102;
+static const size_t SNAPSHOT_HEADER_SIZE = 4 + 2 + 2 + 4;
+static const std::uint32_t SNAPSHOT_MAX_BULLETS = 1u << 20; // Limite de sanidade para a capacidade do pool
+
+// Escrita sequencial em bytes crus
+struct SnapshotWriter {
+    std::vector<unsigned char>& out;
+
+    template <typename T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "so tipos simples");
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(&value);
+        out.insert(out.end(), p, p + sizeof(T));
+    }
+
+    void putVec(sf::Vector2f v) {
+        put(v.x);
+        put(v.y);
+    }
+
+    template <typename T>
+    void putArray(const T* data, size_t count) {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+        out.insert(out.end(), p, p + count * sizeof(T));
+    }
+};
+
+// Leitura sequencial com checagem de limites. Com 'apply' falso só confere o
+// formato; com 'apply' verdadeiro também escreve nos destinos.
+struct SnapshotReader {
+    const unsigned char* p;
+    const unsigned char* end;
+    bool apply;
+    bool ok = true;
+
+    template <typename T>
+    T value() {
+        T v{};
+        if (!ok || static_cast<size_t>(end - p) < sizeof(T)) {
+            ok = false;
+            return v;
+        }
+        std::memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+        return v;
+    }
+
+    template <typename T>
+    void read(T& dst) {
+        T v = value<T>();
+        if (apply && ok) dst = v;
+    }
+
+    sf::Vector2f vec() {
+        float x = value<float>();
+        float y = value<float>();
+        return sf::Vector2f(x, y);
+    }
+
+    template <typename T>
+    void readArray(std::vector<T>& dst, size_t count) {
+        if (!ok || count > static_cast<size_t>(end - p) / sizeof(T)) {
+            ok = false;
+            return;
+        }
+        if (apply) {
+            dst.resize(count);
+            if (count > 0) std::memcpy(dst.data(), p, count * sizeof(T));
+        }
+        p += count * sizeof(T);
+    }
+
+    bool check(bool condition) {
+        if (!condition) ok = false;
+        return ok;
+    }
+};
+
+static void writePlayer(SnapshotWriter& w, const Player& player) {
+    w.putVec(player.shape.getPosition());
+    w.putVec(player.lastDir);
+    w.put<std::uint8_t>(player.alive ? 1 : 0);
+    w.put(player.shootTimer);
+    w.put(player.abilityTimer);
+}
+
+static void readPlayer(SnapshotReader& r, Player& player) {
+    sf::Vector2f pos = r.vec();
+    sf::Vector2f dir = r.vec();
+    std::uint8_t alive = r.value<std::uint8_t>();
+    float shootTimer = r.value<float>();
+    float abilityTimer = r.value<float>();
+    if (!r.apply || !r.ok) return;
+    player.shape.setPosition(pos);
+    player.prevPosition = pos;
+    player.lastDir = dir;
+    player.alive = alive != 0;
+    player.shootTimer = shootTimer;
+    player.abilityTimer = abilityTimer;
+}
+
+void saveSnapshot(const Simulation& sim, std::vector<unsigned char>& out) {
+    out.clear();
+    SnapshotWriter w{out};
+
+    out.insert(out.end(), { 'Z', 'S', 'N', 'P' });
+    w.put(SNAPSHOT_VERSION);
+    w.put(SNAPSHOT_BYTE_ORDER);
+    w.put<std::uint32_t>(0); // Tamanho total, preenchido no fim
+
+    const SimConfig& c = sim.config;
+    w.put(c.zombieSpeed);
+    w.put(c.zombieSpawnTime);
+    w.put(c.bulletRate);
+    w.put(c.barrierLife);
+    w.put(c.explosionRadius);
+    w.put(c.explosionChainDepth);
+    w.put<std::uint8_t>(c.barricadesBlockBullets ? 1 : 0);
+    w.put(c.initialZombies);
+    w.put(c.zombieIncrementPerWave);
+    w.put(sim.rng.state);
+    w.put(sim.rng.inc);
+
+    writePlayer(w, sim.player1);
+    writePlayer(w, sim.player2);
+    w.putVec(sim.base.getPosition());
+
+    // Waves
+    w.put(sim.currentWave);
+    w.put(sim.zombiesToSpawn);
+    w.put(sim.zombiesSpawnedThisWave);
+    w.put(sim.zombiesRemaining);
+    w.put(sim.spawnTimer);
+    w.put<std::uint8_t>(sim.gameOver ? 1 : 0);
+    w.put(sim.zombiesKilled);
+    w.put(sim.barricadeVersion);
+
+    // Efeitos de área, na ordem do pool (a ordem decide quem detona primeiro)
+    const AreaEffectPool& fx = sim.effects;
+    w.put(static_cast<std::uint32_t>(fx.size()));
+    w.put(fx.overflows);
+    for (const AreaEffect& e : fx.items) {
+        w.putVec(e.position);
+        w.putVec(e.direction);
+        w.put(e.coneCos);
+        w.put(e.radius);
+        w.put(e.currentRadius);
+        w.put(e.expandSpeed);
+        w.put(e.fadeSpeed);
+        w.put(e.alpha);
+        w.put(e.fuse);
+        w.put(e.chainDepth);
+        w.put(static_cast<std::uint8_t>(e.shape));
+        w.put(e.owner);
+        w.put<std::uint8_t>(e.detonated ? 1 : 0);
+    }
+
+    // Barricadas, na ordem do pool (a ordem decide contatos e remoções)
+    const EntityPool<Barricade>& bars = sim.barricades;
+    w.put(static_cast<std::uint32_t>(bars.items.size()));
+    for (const Barricade& bar : bars.items) {
+        w.putVec(bar.shape.getPosition());
+        w.put(bar.health);
+        w.put(bar.maxHealth);
+    }
+
+    // Zumbis (entre ticks todos estão vivos e as posições anteriores não importam)
+    const ZombieStore& zs = sim.zombies;
+    w.put(static_cast<std::uint32_t>(zs.size()));
+    w.putArray(zs.x.data(), zs.size());
+    w.putArray(zs.y.data(), zs.size());
+    w.putArray(zs.radius.data(), zs.size());
+    w.putArray(zs.id.data(), zs.size());
+    w.put(zs.nextId);
+
+    // Balas ativas com o slot de cada uma (a ordem dos slots decide colisões)
+    const BulletPool& bp = sim.bullets;
+    w.put(static_cast<std::uint32_t>(bp.capacity()));
+    w.put(bp.head);
+    w.put(bp.overflows);
+    w.put(static_cast<std::uint32_t>(bp.count));
+    for (int i = 0; i < bp.capacity(); ++i) {
+        const Bullet& b = bp.slots[i];
+        if (!b.active) continue;
+        w.put(static_cast<std::uint32_t>(i));
+        w.putVec(b.position);
+        w.putVec(b.velocity);
+        w.putVec(b.origin);
+        w.put(b.owner);
+    }
+
+    std::uint32_t total = static_cast<std::uint32_t>(out.size());
+    std::memcpy(out.data() + 8, &total, sizeof(total));
+}
+
+// Lê o corpo do snapshot; ver SnapshotReader::apply
+static bool readBody(SnapshotReader& r, Simulation& sim) {
+    SimConfig& c = sim.config;
+    r.read(c.zombieSpeed);
+    r.read(c.zombieSpawnTime);
+    r.read(c.bulletRate);
+    r.read(c.barrierLife);
+    r.read(c.explosionRadius);
+    r.read(c.explosionChainDepth);
+    std::uint8_t blockBullets = r.value<std::uint8_t>();
+    if (r.apply && r.ok) c.barricadesBlockBullets = blockBullets != 0;
+    r.read(c.initialZombies);
+    r.read(c.zombieIncrementPerWave);
+    r.read(sim.rng.state);
+    r.read(sim.rng.inc);
+
+    readPlayer(r, sim.player1);
+    readPlayer(r, sim.player2);
+    sf::Vector2f basePos = r.vec();
+    if (r.apply && r.ok) sim.base.setPosition(basePos);
+
+    r.read(sim.currentWave);
+    r.read(sim.zombiesToSpawn);
+    r.read(sim.zombiesSpawnedThisWave);
+    r.read(sim.zombiesRemaining);
+    r.read(sim.spawnTimer);
+    std::uint8_t gameOver = r.value<std::uint8_t>();
+    r.read(sim.zombiesKilled);
+    r.read(sim.barricadeVersion);
+
+    // Efeitos de área
+    AreaEffectPool& fx = sim.effects;
+    std::uint32_t effectCount = r.value<std::uint32_t>();
+    int effectOverflows = r.value<int>();
+    if (!r.check(effectCount <= AREA_EFFECT_CAPACITY)) return false;
+    if (r.apply && r.ok) {
+        if (fx.capacity != AREA_EFFECT_CAPACITY) fx.init(AREA_EFFECT_CAPACITY);
+        fx.clear();
+        fx.overflows = effectOverflows;
+    }
+    for (std::uint32_t i = 0; r.ok && i < effectCount; ++i) {
+        AreaEffect e;
+        e.position = r.vec();
+        e.direction = r.vec();
+        e.coneCos = r.value<float>();
+        e.radius = r.value<float>();
+        e.currentRadius = r.value<float>();
+        e.expandSpeed = r.value<float>();
+        e.fadeSpeed = r.value<float>();
+        e.alpha = r.value<float>();
+        e.fuse = r.value<float>();
+        e.chainDepth = r.value<int>();
+        std::uint8_t shape = r.value<std::uint8_t>();
+        e.owner = r.value<std::uint8_t>();
+        e.detonated = r.value<std::uint8_t>() != 0;
+        if (!r.check(shape <= AreaCone)) break;
+        e.shape = static_cast<AreaShape>(shape);
+        if (r.apply && r.ok) fx.items.push_back(e);
+    }
+
+    // Barricadas
+    EntityPool<Barricade>& bars = sim.barricades;
+    std::uint32_t barCount = r.value<std::uint32_t>();
+    if (!r.check(barCount <= static_cast<size_t>(r.end - r.p) / 16)) return false;
+    if (r.apply) bars.items.clear();
+    for (std::uint32_t i = 0; i < barCount; ++i) {
+        sf::Vector2f pos = r.vec();
+        int health = r.value<int>();
+        int maxHealth = r.value<int>();
+        if (!r.check(maxHealth > 0 && health > 0 && health <= maxHealth)) return false;
+        if (r.apply) {
+            Barricade bar = makeBarricade(pos, maxHealth);
+            bar.health = health;
+            bars.items.push_back(bar);
+        }
+    }
+
+    // Zumbis
+    ZombieStore& zs = sim.zombies;
+    std::uint32_t zombieCount = r.value<std::uint32_t>();
+    r.readArray(zs.x, zombieCount);
+    r.readArray(zs.y, zombieCount);
+    r.readArray(zs.radius, zombieCount);
+    const unsigned char* idBytes = r.p;
+    r.readArray(zs.id, zombieCount);
+    std::uint32_t nextId = r.value<std::uint32_t>();
+    for (std::uint32_t i = 0; r.ok && i < zombieCount; ++i) {
+        std::uint32_t id;
+        std::memcpy(&id, idBytes + i * sizeof(id), sizeof(id));
+        r.check(id < nextId); // Ids saem de nextId, então os salvos são menores
+    }
+    if (r.apply && r.ok) zs.nextId = nextId;
+
+    // Balas
+    BulletPool& bp = sim.bullets;
+    std::uint32_t capacity = r.value<std::uint32_t>();
+    int head = r.value<int>();
+    int overflows = r.value<int>();
+    std::uint32_t active = r.value<std::uint32_t>();
+    r.check(capacity > 0 && capacity <= SNAPSHOT_MAX_BULLETS && head >= 0 && static_cast<std::uint32_t>(head) < capacity && active <= capacity);
+    if (r.apply && r.ok) {
+        if (static_cast<std::uint32_t>(bp.capacity()) != capacity) bp.init(static_cast<int>(capacity));
+        else bp.clear();
+        bp.head = head;
+        bp.overflows = overflows;
+        bp.count = static_cast<int>(active);
+    }
+    // Slots em ordem crescente (como saveSnapshot grava): nenhum repetido,
+    // então a contagem de ativas bate com os slots marcados
+    long long previousSlot = -1;
+    for (std::uint32_t k = 0; r.ok && k < active; ++k) {
+        std::uint32_t slot = r.value<std::uint32_t>();
+        sf::Vector2f pos = r.vec();
+        sf::Vector2f vel = r.vec();
+        sf::Vector2f origin = r.vec();
+        std::uint8_t owner = r.value<std::uint8_t>();
+        if (!r.check(slot < capacity && static_cast<long long>(slot) > previousSlot &&
+                     (owner == OwnerPlayer1 || owner == OwnerPlayer2))) break;
+        previousSlot = slot;
+        if (r.apply) {
+            Bullet& b = bp.slots[slot];
+            b.position = pos;
+            b.prevPosition = pos;
+            b.velocity = vel;
+            b.origin = origin;
+            b.owner = owner;
+            b.active = true;
+        }
+    }
+
+    if (!r.check(r.p == r.end)) return false;
+    if (!r.apply) return true;
+
+    sim.gameOver = gameOver != 0;
+
+    zs.prevX = zs.x;
+    zs.prevY = zs.y;
+    zs.alive.assign(zs.size(), 1);
+    zs.dead.clear();
+
+    // O campo de fluxo e as listas de barricadas por célula são refeitos no
+    // próximo tick com as barricadas restauradas (a versão salva pode bater
+    // com a de listas montadas em outra linha do tempo)
+    sim.flowField.built = false;
+    sim.barricadeCellsBuilt = false;
+    return true;
+}
+
+bool loadSnapshot(Simulation& sim, const unsigned char* data, size_t size) {
+    if (size < SNAPSHOT_HEADER_SIZE || std::memcmp(data, "ZSNP", 4) != 0) return false;
+    std::uint16_t version, byteOrder;
+    std::uint32_t total;
+    std::memcpy(&version, data + 4, 2);
+    std::memcpy(&byteOrder, data + 6, 2);
+    std::memcpy(&total, data + 8, 4);
+    if (version != SNAPSHOT_VERSION || byteOrder != SNAPSHOT_BYTE_ORDER || total != size) return false;
+
+    // Primeiro confere tudo, depois escreve: um snapshot inválido não deixa a simulação pela metade
+    SnapshotReader verifyPass{data + SNAPSHOT_HEADER_SIZE, data + size, false};
+    if (!readBody(verifyPass, sim)) return false;
+    SnapshotReader applyPass{data + SNAPSHOT_HEADER_SIZE, data + size, true};
+    return readBody(applyPass, sim);
+}
+
+#ifndef _WIN32
+
+bool saveSnapshotFile(const char* path, const std::vector<unsigned char>& bytes) {
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    bool ok = ftruncate(fd, static_cast<off_t>(bytes.size())) == 0;
+    if (ok) {
+        void* map = mmap(nullptr, bytes.size(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ok = map != MAP_FAILED;
+        if (ok) {
+            std::memcpy(map, bytes.data(), bytes.size());
+            munmap(map, bytes.size());
+        }
+    }
+    return close(fd) == 0 && ok;
+}
+
+bool loadSnapshotFile(const char* path, Simulation& sim) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0 && st.st_size > 0;
+    if (ok) {
+        size_t size = static_cast<size_t>(st.st_size);
+        void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ok = map != MAP_FAILED;
+        if (ok) {
+            ok = loadSnapshot(sim, static_cast<const unsigned char*>(map), size);
+            munmap(map, size);
+        }
+    }
+    close(fd);
+    return ok;
+}
+
+#else
+
+// Sem mmap POSIX: lê e grava com stdio
+bool saveSnapshotFile(const char* path, const std::vector<unsigned char>& bytes) {
+    std::FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+bool loadSnapshotFile(const char* path, Simulation& sim) {
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) return false;
+    std::vector<unsigned char> bytes;
+    unsigned char chunk[4096];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) bytes.insert(bytes.end(), chunk, chunk + n);
+    std::fclose(f);
+    return !bytes.empty() && loadSnapshot(sim, bytes.data(), bytes.size());
+}
+
+#endif
+
+void SnapshotRing::init(size_t capacity) {
+    buffers.assign(capacity, std::vector<unsigned char>());
+    ticks.assign(capacity, 0);
+    clear();
+}
+
+void SnapshotRing::push(const Simulation& sim, long long tick) {
+    if (buffers.empty()) return;
+    saveSnapshot(sim, buffers[head]);
+    ticks[head] = tick;
+    head = (head + 1) % buffers.size();
+    if (count < buffers.size()) count++;
+}
+
+bool SnapshotRing::rewind(Simulation& sim, size_t back, long long& tick) {
+    if (count == 0) return false;
+    if (back >= count) back = count - 1;
+    size_t cap = buffers.size();
+    size_t slot = (head + cap - 1 - back) % cap;
+    if (!loadSnapshot(sim, buffers[slot].data(), buffers[slot].size())) return false;
+    tick = ticks[slot];
+
+    // O restaurado passa a ser o mais novo
+    head = (slot + 1) % cap;
+    count -= back;
+    return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "simulation.hpp"
+
+// Snapshots binários do estado da simulação, para salvar, continuar e voltar
+// no tempo. Guardam tudo o que o próximo tick lê (config, gerador, players,
+// base, waves, efeitos de área, barricadas na ordem do pool,
+// zumbis e balas ativas com o slot de cada uma); caches que dependem só
+// desse estado (campo de fluxo, grade, buffers de trabalho) são refeitos.
+// Arrays da horda são copiados inteiros com memcpy, então salvar e restaurar
+// milhares de zumbis leva microssegundos, e os buffers são reaproveitados.
+//
+// Formato (ordem de bytes da máquina, conferida no cabeçalho):
+//   "ZSNP", versão (u16), marca de ordem de bytes (u16), tamanho total (u32),
+//   seguido dos blocos na ordem de saveSnapshot().
+// Restaurar um snapshot e rodar as mesmas entradas reproduz os mesmos ticks
+// (o mesmo hashSimulation()).
+
+const std::uint16_t SNAPSHOT_VERSION = 7;
+
+// Serializa 'sim' em 'out' (sobrescreve; a capacidade é reaproveitada)
+void saveSnapshot(const Simulation& sim, std::vector<unsigned char>& out);
+
+// Restaura 'sim' a partir do snapshot. 'sim' precisa ter passado por
+// initSimulation(). Devolve false (sem mexer em 'sim') se os bytes não são um
+// snapshot válido desta versão.
+bool loadSnapshot(Simulation& sim, const unsigned char* data, size_t size);
+
+// Gravação e leitura em disco por arquivo mapeado em memória: o snapshot é
+// copiado direto para o mapeamento e restaurado direto dele
+bool saveSnapshotFile(const char* path, const std::vector<unsigned char>& bytes);
+bool loadSnapshotFile(const char* path, Simulation& sim);
+
+// Ticks entre snapshots do anel de rewind e quantos ficam guardados
+const int SNAPSHOT_INTERVAL_TICKS = 10;
+const size_t SNAPSHOT_RING_CAPACITY = 64; // ~10 s a 60 ticks/s
+
+// Anel dos snapshots recentes para voltar no tempo na hora. Os buffers são
+// alocados na primeira volta e reaproveitados depois.
+struct SnapshotRing {
+    std::vector<std::vector<unsigned char>> buffers;
+    std::vector<long long> ticks; // Tick de cada snapshot
+    size_t head = 0;  // Próximo slot a ser escrito
+    size_t count = 0;
+
+    void init(size_t capacity);
+    void clear() { head = 0; count = 0; }
+    size_t size() const { return count; }
+
+    // Guarda o estado atual como o snapshot mais novo
+    void push(const Simulation& sim, long long tick);
+
+    // Restaura o snapshot 'back' posições antes do mais novo (0 = o mais novo,
+    // limitado ao mais antigo) e descarta os mais novos que ele. Devolve false
+    // se o anel está vazio; 'tick' recebe o tick restaurado.
+    bool rewind(Simulation& sim, size_t back, long long& tick);
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+// Grade uniforme (spatial hash) sobre o mundo para a broadphase de colisões.
+// É reconstruída a cada tick com counting sort: 'cellStart' guarda, para cada
+// célula, o início da sua fatia em 'entries' (índices dos itens). Itens fora
+// da área da grade caem nas células da borda, então nada se perde.
+struct SpatialGrid {
+    float originX = 0.f;
+    float originY = 0.f;
+    float cellSize = 64.f;
+    int cols = 0;
+    int rows = 0;
+
+    std::vector<int> cellStart; // cols * rows + 1 posições
+    std::vector<int> entries;   // índices dos itens, agrupados por célula
+    std::vector<int> itemCell;  // célula de cada item (temporário do build)
+    std::vector<int> cursor;    // próxima posição livre de cada célula (temporário do build)
+
+    // Define a área coberta e o tamanho das células (não reconstrói)
+    void init(float minX, float minY, float maxX, float maxY, float cell) {
+        originX = minX;
+        originY = minY;
+        cellSize = cell;
+        cols = std::max(1, static_cast<int>((maxX - minX) / cell) + 1);
+        rows = std::max(1, static_cast<int>((maxY - minY) / cell) + 1);
+        cellStart.assign(cols * rows + 1, 0);
+    }
+
+    // Célula de uma coordenada, presa à borda da grade (comparação em float evita overflow no cast)
+    int cellX(float x) const {
+        float fx = (x - originX) / cellSize;
+        if (!(fx > 0.f)) return 0;
+        if (fx >= static_cast<float>(cols)) return cols - 1;
+        return static_cast<int>(fx);
+    }
+
+    int cellY(float y) const {
+        float fy = (y - originY) / cellSize;
+        if (!(fy > 0.f)) return 0;
+        if (fy >= static_cast<float>(rows)) return rows - 1;
+        return static_cast<int>(fy);
+    }
+
+    // Reconstrói a grade com 'count' itens; getPos(i) devolve a posição (x, y) do item i
+    template <typename GetPos>
+    void build(int count, GetPos getPos) {
+        itemCell.resize(count);
+        entries.resize(count);
+        std::fill(cellStart.begin(), cellStart.end(), 0);
+
+        // Conta os itens por célula
+        for (int i = 0; i < count; ++i) {
+            auto p = getPos(i);
+            int c = cellY(p.y) * cols + cellX(p.x);
+            itemCell[i] = c;
+            cellStart[c + 1]++;
+        }
+        // Soma de prefixos: cellStart[c] vira o início da célula c
+        for (int c = 0; c < cols * rows; ++c) {
+            cellStart[c + 1] += cellStart[c];
+        }
+        // Distribui os índices; cada célula fica em ordem crescente de índice
+        cursor.assign(cellStart.begin(), cellStart.end() - 1);
+        for (int i = 0; i < count; ++i) {
+            entries[cursor[itemCell[i]]++] = i;
+        }
+    }
+
+    // Visita os índices de todos os itens nas células que tocam o retângulo dado
+    template <typename Visit>
+    void query(float minX, float minY, float maxX, float maxY, Visit visit) const {
+        int x0 = cellX(minX), x1 = cellX(maxX);
+        int y0 = cellY(minY), y1 = cellY(maxY);
+        for (int cy = y0; cy <= y1; ++cy) {
+            for (int cx = x0; cx <= x1; ++cx) {
+                int c = cy * cols + cx;
+                for (int k = cellStart[c]; k < cellStart[c + 1]; ++k) {
+                    visit(entries[k]);
+                }
+            }
+        }
+    }
+};
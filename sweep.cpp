@@ -0,0 +1,257 @@
+#include "sweep.hpp"
+#include "headless.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+// Parâmetros que a varredura sabe variar, na ordem das colunas do CSV
+struct SweepField {
+    const char* name;
+    void (*set)(SimConfig& c, double v);
+    double (*get)(const SimConfig& c);
+};
+
+static const SweepField SWEEP_FIELDS[] = {
+    { "zombie_speed",
+      [](SimConfig& c, double v) { c.zombieSpeed = static_cast<float>(v); },
+      [](const SimConfig& c) { return static_cast<double>(c.zombieSpeed); } },
+    { "zombie_spawn_time",
+      [](SimConfig& c, double v) { c.zombieSpawnTime = static_cast<float>(v); },
+      [](const SimConfig& c) { return static_cast<double>(c.zombieSpawnTime); } },
+    { "bullet_rate",
+      [](SimConfig& c, double v) { c.bulletRate = static_cast<float>(v); },
+      [](const SimConfig& c) { return static_cast<double>(c.bulletRate); } },
+    { "barrier_life",
+      [](SimConfig& c, double v) { c.barrierLife = static_cast<int>(std::lround(v)); },
+      [](const SimConfig& c) { return static_cast<double>(c.barrierLife); } },
+    { "explosion_radius",
+      [](SimConfig& c, double v) { c.explosionRadius = static_cast<float>(v); },
+      [](const SimConfig& c) { return static_cast<double>(c.explosionRadius); } },
+    { "explosion_chain_depth",
+      [](SimConfig& c, double v) { c.explosionChainDepth = static_cast<int>(std::lround(v)); },
+      [](const SimConfig& c) { return static_cast<double>(c.explosionChainDepth); } },
+    { "barricades_block_bullets",
+      [](SimConfig& c, double v) { c.barricadesBlockBullets = std::lround(v) != 0; },
+      [](const SimConfig& c) { return c.barricadesBlockBullets ? 1.0 : 0.0; } },
+    { "initial_zombies",
+      [](SimConfig& c, double v) { c.initialZombies = static_cast<int>(std::lround(v)); },
+      [](const SimConfig& c) { return static_cast<double>(c.initialZombies); } },
+    { "zombie_increment_per_wave",
+      [](SimConfig& c, double v) { c.zombieIncrementPerWave = static_cast<int>(std::lround(v)); },
+      [](const SimConfig& c) { return static_cast<double>(c.zombieIncrementPerWave); } },
+};
+
+static const int SWEEP_FIELD_COUNT = static_cast<int>(sizeof(SWEEP_FIELDS) / sizeof(SWEEP_FIELDS[0]));
+
+// Tira espaços do começo e do fim
+static std::string trim(const std::string& s) {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos) return std::string();
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
+static bool parseNumber(const std::string& token, double& out) {
+    char* end = nullptr;
+    out = std::strtod(token.c_str(), &end);
+    return end != token.c_str() && *end == '\0';
+}
+
+// "a b c" ou "inicio:fim:passo"
+static bool parseValues(const std::string& text, std::vector<double>& values) {
+    values.clear();
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t next = text.find_first_of(" \t", pos);
+        std::string token = text.substr(pos, next == std::string::npos ? std::string::npos : next - pos);
+        pos = next == std::string::npos ? text.size() : next + 1;
+        if (token.empty()) continue;
+
+        size_t c1 = token.find(':');
+        if (c1 == std::string::npos) {
+            double v;
+            if (!parseNumber(token, v)) return false;
+            values.push_back(v);
+            continue;
+        }
+        size_t c2 = token.find(':', c1 + 1);
+        double start, stop, step;
+        if (c2 == std::string::npos ||
+            !parseNumber(token.substr(0, c1), start) ||
+            !parseNumber(token.substr(c1 + 1, c2 - c1 - 1), stop) ||
+            !parseNumber(token.substr(c2 + 1), step) ||
+            step <= 0.0 || stop < start) {
+            return false;
+        }
+        // Conta os passos em inteiro para o fim entrar mesmo com erro de arredondamento
+        long long n = static_cast<long long>(std::floor((stop - start) / step + 1e-9)) + 1;
+        for (long long k = 0; k < n; ++k) values.push_back(start + k * step);
+    }
+    return !values.empty();
+}
+
+bool SweepSpec::load(const char* path, std::string& error) {
+    std::FILE* f = std::fopen(path, "r");
+    if (!f) {
+        error = "nao foi possivel abrir o arquivo";
+        return false;
+    }
+
+    params.clear();
+    char buffer[1024];
+    int lineNumber = 0;
+    bool ok = true;
+    while (ok && std::fgets(buffer, sizeof(buffer), f)) {
+        lineNumber++;
+        std::string line = buffer;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        line = trim(line);
+        if (line.empty()) continue;
+
+        size_t eq = line.find('=');
+        std::string key = eq == std::string::npos ? std::string() : trim(line.substr(0, eq));
+        std::string value = eq == std::string::npos ? std::string() : trim(line.substr(eq + 1));
+        std::vector<double> values;
+        if (key.empty() || !parseValues(value, values)) {
+            ok = false;
+        } else if (key == "games") {
+            games = static_cast<int>(values[0]);
+            ok = games > 0;
+        } else if (key == "max_ticks") {
+            maxTicks = static_cast<long long>(values[0]);
+            ok = maxTicks > 0;
+        } else if (key == "threads") {
+            threads = static_cast<int>(values[0]);
+        } else {
+            int field = -1;
+            for (int k = 0; k < SWEEP_FIELD_COUNT; ++k) {
+                if (key == SWEEP_FIELDS[k].name) field = k;
+            }
+            ok = field >= 0;
+            if (ok) {
+                SweepParam p;
+                p.field = field;
+                p.values = values;
+                params.push_back(p);
+            }
+        }
+        if (!ok) error = "linha " + std::to_string(lineNumber) + " invalida: " + line;
+    }
+    std::fclose(f);
+    return ok;
+}
+
+size_t SweepSpec::combinations() const {
+    size_t n = 1;
+    for (const SweepParam& p : params) n *= p.values.size();
+    return n;
+}
+
+SimConfig SweepSpec::config(size_t index) const {
+    SimConfig c;
+    for (size_t k = params.size(); k-- > 0;) {
+        const SweepParam& p = params[k];
+        SWEEP_FIELDS[p.field].set(c, p.values[index % p.values.size()]);
+        index /= p.values.size();
+    }
+    return c;
+}
+
+SweepResult runSweepGame(const SimConfig& config, std::uint64_t seed, long long maxTicks) {
+    auto start = std::chrono::steady_clock::now();
+
+    Simulation sim;
+    initSimulation(sim, config);
+    startGame(sim, seed);
+
+    long long t = 0;
+    while (t < maxTicks && !sim.gameOver) {
+        stepSimulation(sim, scriptedInput(sim, t), HEADLESS_DT);
+        t++;
+    }
+
+    SweepResult r;
+    r.config = config;
+    r.seed = seed;
+    r.wavesSurvived = sim.currentWave - 1;
+    r.ticks = t;
+    r.kills = sim.zombiesKilled;
+    r.gameOver = sim.gameOver;
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return r;
+}
+
+int runSweep(const char* specPath, const char* csvPath) {
+    SweepSpec spec;
+    std::string error;
+    if (!spec.load(specPath, error)) {
+        std::fprintf(stderr, "sweep: %s: %s\n", specPath, error.c_str());
+        return 2;
+    }
+
+    const size_t combos = spec.combinations();
+    const size_t runs = combos * static_cast<size_t>(spec.games);
+    std::vector<SweepResult> results(runs);
+
+    // Cada partida roda inteira numa thread (sem paralelismo dentro do tick).
+    // As threads pegam a próxima partida de um contador compartilhado, então
+    // partidas longas não deixam núcleos parados esperando.
+    JobSystem jobs;
+    jobs.init(spec.threads);
+    std::printf("sweep: %zu combinacoes x %d partidas = %zu partidas em %d threads\n",
+                combos, spec.games, runs, jobs.threadCount());
+    std::fflush(stdout);
+
+    std::atomic<size_t> nextRun{0};
+    std::atomic<size_t> finished{0};
+    std::mutex progressMutex;
+    size_t lastPercent = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    jobs.parallelFor(static_cast<size_t>(jobs.threadCount()), 1, [&](size_t, size_t) {
+        for (size_t run = nextRun.fetch_add(1); run < runs; run = nextRun.fetch_add(1)) {
+            size_t combo = run / spec.games;
+            std::uint64_t seed = SWEEP_SEED + run % spec.games;
+            results[run] = runSweepGame(spec.config(combo), seed, spec.maxTicks);
+
+            size_t done = finished.fetch_add(1) + 1;
+            size_t percent = done * 100 / runs;
+            std::lock_guard<std::mutex> lock(progressMutex);
+            if (percent > lastPercent) {
+                lastPercent = percent;
+                double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                std::fprintf(stderr, "\rsweep: %3zu%% (%zu/%zu), %.0f s", percent, done, runs, elapsed);
+            }
+        }
+    });
+    double totalSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fprintf(stderr, "\n");
+
+    std::FILE* out = std::fopen(csvPath, "w");
+    if (!out) {
+        std::fprintf(stderr, "sweep: nao foi possivel gravar %s\n", csvPath);
+        return 1;
+    }
+    std::fprintf(out, "run,combination,seed");
+    for (int k = 0; k < SWEEP_FIELD_COUNT; ++k) std::fprintf(out, ",%s", SWEEP_FIELDS[k].name);
+    std::fprintf(out, ",waves_survived,ticks,kills,game_over,seconds\n");
+    long long totalTicks = 0;
+    for (size_t run = 0; run < runs; ++run) {
+        const SweepResult& r = results[run];
+        std::fprintf(out, "%zu,%zu,%llu", run, run / spec.games, static_cast<unsigned long long>(r.seed));
+        for (int k = 0; k < SWEEP_FIELD_COUNT; ++k) std::fprintf(out, ",%g", SWEEP_FIELDS[k].get(r.config));
+        std::fprintf(out, ",%d,%lld,%d,%d,%.3f\n", r.wavesSurvived, r.ticks, r.kills, r.gameOver ? 1 : 0, r.seconds);
+        totalTicks += r.ticks;
+    }
+    std::fclose(out);
+
+    std::printf("sweep: %zu partidas, %lld ticks em %.1f s (%.0f ticks/s) -> %s\n",
+                runs, totalTicks, totalSec, totalSec > 0.0 ? totalTicks / totalSec : 0.0, csvPath);
+    return 0;
+}
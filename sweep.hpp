@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "simulation.hpp"
+
+// Varredura de parâmetros: roda milhares de partidas headless independentes
+// (bot de headless.hpp) com combinações dos campos de SimConfig, espalhadas
+// por todos os núcleos, e grava uma linha de CSV por partida.
+//
+// Arquivo de especificação, uma entrada por linha ('#' começa comentário):
+//   zombie_speed = 40 60 80          lista de valores
+//   zombie_spawn_time = 0.3:0.7:0.1  início:fim:passo (fim incluído)
+//   games = 16                       partidas (sementes) por combinação
+//   max_ticks = 216000               limite de ticks por partida
+//   threads = 0                      threads (0 = todos os núcleos)
+// Parâmetros: zombie_speed, zombie_spawn_time, bullet_rate, barrier_life,
+// explosion_radius, explosion_chain_depth, barricades_block_bullets (0 ou 1),
+// initial_zombies, zombie_increment_per_wave. Os que não
+// aparecem ficam no padrão. Toda combinação usa as mesmas sementes, então as
+// comparações entre combinações são pareadas.
+// Uso: ./jogo --sweep spec.txt [resultados.csv]
+
+// Semente da partida g de cada combinação: SWEEP_SEED + g
+const std::uint64_t SWEEP_SEED = 1000;
+
+struct SweepParam {
+    int field = -1;             // Índice na tabela de parâmetros (sweep.cpp)
+    std::vector<double> values;
+};
+
+struct SweepSpec {
+    std::vector<SweepParam> params;
+    int games = 1;
+    long long maxTicks = 60LL * 60 * DEFAULT_TICK_RATE; // Uma hora de jogo
+    int threads = 0;
+
+    // Lê o arquivo; em caso de erro devolve false e preenche 'error'
+    bool load(const char* path, std::string& error);
+
+    // Número de combinações de valores (produto dos tamanhos das listas)
+    size_t combinations() const;
+
+    // Configuração da combinação 'index' (ordem lexicográfica, o último parâmetro varia mais rápido)
+    SimConfig config(size_t index) const;
+};
+
+// Resultado de uma partida
+struct SweepResult {
+    SimConfig config;
+    std::uint64_t seed = 0;
+    int wavesSurvived = 0; // Waves completas antes do fim
+    long long ticks = 0;
+    int kills = 0;
+    bool gameOver = false; // false = parou em max_ticks
+    double seconds = 0.0;
+};
+
+// Roda uma partida do bot até o game over ou 'maxTicks'
+SweepResult runSweepGame(const SimConfig& config, std::uint64_t seed, long long maxTicks);
+
+// Roda a varredura e grava o CSV. Retorna o código de saída.
+int runSweep(const char* specPath, const char* csvPath);
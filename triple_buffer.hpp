@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Buffer triplo sem trava para um produtor e um consumidor: o produtor
+// escreve sempre no seu buffer e publica trocando-o pelo do meio; o
+// consumidor troca o seu pelo do meio quando há um publicado que ele ainda
+// não leu. Os dois nunca esperam um pelo outro nem tocam no mesmo buffer, e
+// o consumidor sempre pega o mais novo (os intermediários são pulados).
+//
+// Os três buffers são criados uma vez; quem usa reaproveita o conteúdo
+// (vetores já alocados) a cada publicação.
+template <typename T>
+struct TripleBuffer {
+    T buffers[3];
+
+    // Buffer onde o produtor escreve a próxima publicação
+    T& writeBuffer() { return buffers[back]; }
+
+    // Publica o buffer de escrita. Devolve true se o buffer que voltou para
+    // o produtor tinha sido publicado e nunca lido (o consumidor pulou).
+    bool publish() {
+        std::uint8_t previous = middle.exchange(static_cast<std::uint8_t>(back | FRESH), std::memory_order_acq_rel);
+        back = previous & INDEX;
+        return (previous & FRESH) != 0;
+    }
+
+    // Pega a publicação mais nova, se houver uma não lida; false mantém a atual
+    bool acquire() {
+        if ((middle.load(std::memory_order_acquire) & FRESH) == 0) return false;
+        std::uint8_t previous = middle.exchange(front, std::memory_order_acq_rel);
+        front = previous & INDEX;
+        return true;
+    }
+
+    // Última publicação pega pelo consumidor
+    const T& readBuffer() const { return buffers[front]; }
+
+private:
+    static const std::uint8_t INDEX = 3;
+    static const std::uint8_t FRESH = 4;
+
+    std::uint8_t back = 0;  // Só o produtor
+    std::uint8_t front = 1; // Só o consumidor
+    std::atomic<std::uint8_t> middle{2};
+};